@@ -0,0 +1,307 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Benchmark of the cost of reading legacy process metadata from run files.
+//
+// restLegacyIOBenchmark [OPTION=VALUE]...
+//
+//   files=1000            Number of fixture files generated, read as a chain
+//   objects=4             Number of TRestRawZeroSuppresionProcess objects per fixture file
+//   channels=1,16,256,4096  Sizes of the channel lists, one TRestRawSignalRecoverChannelsProcess per size
+//   dir=restLegacyIOFixtures  Directory where the fixture files are written
+//   input=                Comma separated list of files, or @FILELIST, to be read instead of the fixtures
+//
+// The fixture files contain the classes as currently defined in this library, i.e.
+// TRestRawZeroSuppresionProcess v4 and TRestRawSignalRecoverChannelsProcess v1. Files written by
+// previous REST releases, containing older class versions, are read through the `input` option. The
+// class version reported for each object is the one stored in the streamer info of its file.
+//
+// Each file is read in three ways: creating the objects (TKey::ReadObj), decoding them without creating
+// them (TRestLegacyStreamer) and sharing identical objects (TRestLegacyProcessPool). Each way is measured
+// on the first file alone and on the whole chain. One JSON object per line is printed for each way and
+// group of objects of the same class, version and channel list size, with the time and heap allocations
+// per object. A summary line for each way gives the file open time and the resident memory growth per
+// object, with all the objects of the chain kept alive. Freshly generated fixtures are read from the
+// page cache, so drop the caches before reading archived files to include the disk access.
+//
+// Before the measurements, the channel list sizes given by TKey::ReadObj and TRestLegacyStreamer are
+// compared for every key, and the benchmark fails if they differ.
+
+#include <TClass.h>
+#include <TDataMember.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TVirtualStreamerInfo.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TRestLegacyCatalog.h"
+#include "TRestLegacyProcessPool.h"
+#include "TRestLegacyStreamer.h"
+#include "TRestRawSignalRecoverChannelsProcess.h"
+#include "TRestRawZeroSuppresionProcess.h"
+
+namespace {
+std::atomic<unsigned long long> gAllocations(0);
+}
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+/// The options given in the command line, with their default values
+std::map<std::string, std::string> gOptions = {{"files", "1000"},
+                                               {"objects", "4"},
+                                               {"channels", "1,16,256,4096"},
+                                               {"dir", "restLegacyIOFixtures"},
+                                               {"input", ""}};
+
+std::vector<std::string> Split(const std::string& list) {
+    std::vector<std::string> values;
+    std::stringstream stream(list);
+    for (std::string value; std::getline(stream, value, ',');)
+        if (!value.empty()) values.push_back(value);
+    return values;
+}
+
+/// It returns the resident memory of the process, in bytes
+Long64_t GetResidentMemory() {
+    std::ifstream statm("/proc/self/statm");
+    Long64_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+/// It assigns a private data member of a legacy object, as stored in a file
+template <typename T>
+void SetMember(TObject* obj, const char* name, const T& value) {
+    TDataMember* member = obj->IsA()->GetDataMember(name);
+    *reinterpret_cast<T*>(reinterpret_cast<char*>(obj) + member->GetOffset()) = value;
+}
+
+std::vector<std::string> GenerateFixtures() {
+    const Int_t nFiles = std::atoi(gOptions["files"].c_str());
+    const Int_t nObjects = std::atoi(gOptions["objects"].c_str());
+    const std::string dir = gOptions["dir"];
+    mkdir(dir.c_str(), 0755);
+
+    std::vector<std::string> files;
+    for (Int_t f = 0; f < nFiles; f++) {
+        std::string path = dir + "/run" + std::to_string(f) + ".root";
+        files.push_back(path);
+        std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "RECREATE"));
+
+        // The same parameters repeat along the chain, as they do for the runs of a campaign
+        for (Int_t n = 0; n < nObjects; n++) {
+            TRestRawZeroSuppresionProcess zs;
+            zs.SetName(("zS" + std::to_string(n)).c_str());
+            SetMember(&zs, "fBaseLineRange", TVector2(5 + n, 55 + n));
+            SetMember(&zs, "fIntegralRange", TVector2(10, 500));
+            SetMember(&zs, "fPointThreshold", 3. + n % 3);
+            SetMember(&zs, "fSignalThreshold", 5.);
+            SetMember(&zs, "fNPointsOverThreshold", 5);
+            SetMember(&zs, "fNPointsFlatThreshold", 512);
+            SetMember(&zs, "fSampling", 0.01 * (1 + f % 2));
+            zs.Write();
+        }
+
+        for (const auto& size : Split(gOptions["channels"])) {
+            TRestRawSignalRecoverChannelsProcess recover;
+            recover.SetName(("recover" + size).c_str());
+            std::vector<Int_t> channels(std::atoi(size.c_str()));
+            for (size_t c = 0; c < channels.size(); c++) channels[c] = 3 * c + 1;
+            SetMember(&recover, "fChannelIds", channels);
+            recover.Write();
+        }
+        file->Close();
+    }
+    return files;
+}
+
+/// The class version of each legacy class, as stored in the streamer info of a file
+std::map<std::string, Int_t> GetClassVersions(TFile* file) {
+    std::map<std::string, Int_t> versions;
+    std::unique_ptr<TList> infos(file->GetStreamerInfoList());
+    TIter next(infos.get());
+    while (TVirtualStreamerInfo* info = (TVirtualStreamerInfo*)next())
+        versions[info->GetName()] = std::max(versions[info->GetName()], info->GetClassVersion());
+    return versions;
+}
+
+/// It checks that TKey::ReadObj and TRestLegacyStreamer give the same channel list size for every
+/// TRestRawSignalRecoverChannelsProcess in `files`, so that both ways are measured on the same work
+bool CheckChannelCounts(const std::vector<std::string>& files) {
+    TRestLegacyStreamer streamer;
+    for (const auto& path : files) {
+        std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+        if (file == nullptr || file->IsZombie()) continue;
+
+        TIter next(file->GetListOfKeys());
+        while (TKey* key = (TKey*)next()) {
+            TClass* cl = TClass::GetClass(key->GetClassName());
+            if (cl == nullptr || !cl->InheritsFrom(TRestRawSignalRecoverChannelsProcess::Class())) continue;
+
+            TRestLegacyCatalog::Record record{};
+            std::vector<Int_t> channels;
+            std::unique_ptr<TObject> obj(key->ReadObj());
+            auto recover = dynamic_cast<TRestRawSignalRecoverChannelsProcess*>(obj.get());
+            if (recover == nullptr || !streamer.Decode(file.get(), key, record, channels)) continue;
+
+            if (channels.size() != recover->GetChannelIds().size() ||
+                record.fNChannels != (Int_t)channels.size()) {
+                std::cerr << path << ": " << key->GetName() << " has " << recover->GetChannelIds().size()
+                          << " channels read with ReadObj and " << channels.size()
+                          << " decoded with TRestLegacyStreamer" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// The measurements of a group of objects
+struct Group {
+    Long64_t fObjects = 0;
+    Double_t fSeconds = 0;
+    unsigned long long fAllocations = 0;
+};
+
+/// It reads the legacy objects of `files` using `method`, and prints the measurements
+void Read(const std::string& scenario, const std::string& method, const std::vector<std::string>& files) {
+    TRestLegacyStreamer streamer;
+    std::vector<std::unique_ptr<TObject>> objects;
+    std::vector<std::shared_ptr<const TRestLegacyProcess>> shared;
+    std::map<std::string, Group> groups;
+
+    Long64_t residentStart = GetResidentMemory();
+    Double_t openSeconds = 0;
+    Long64_t nObjects = 0;
+
+    for (const auto& path : files) {
+        auto openStart = std::chrono::steady_clock::now();
+        std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+        openSeconds += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - openStart).count();
+        if (file == nullptr || file->IsZombie()) continue;
+
+        std::map<std::string, Int_t> versions = GetClassVersions(file.get());
+        TIter next(file->GetListOfKeys());
+        while (TKey* key = (TKey*)next()) {
+            TClass* cl = TClass::GetClass(key->GetClassName());
+            if (cl == nullptr || !cl->InheritsFrom(TRestLegacyProcess::Class())) continue;
+
+            Int_t nChannels = -1;
+            unsigned long long allocationsStart = gAllocations;
+            auto start = std::chrono::steady_clock::now();
+            if (method == "readObj") {
+                objects.emplace_back(key->ReadObj());
+                auto recover = dynamic_cast<TRestRawSignalRecoverChannelsProcess*>(objects.back().get());
+                if (recover) nChannels = recover->GetChannelIds().size();
+            } else if (method == "streamer") {
+                // Decode appends to the record and the channel list, so each key starts from empty ones
+                TRestLegacyCatalog::Record record{};
+                std::vector<Int_t> channels;
+                if (!streamer.Decode(file.get(), key, record, channels)) continue;
+                if (record.fClass == TRestLegacyCatalog::kRecoverChannels) nChannels = channels.size();
+            } else {
+                shared.push_back(TRestLegacyProcessPool::Instance().Read(file.get(), key->GetName()));
+                auto recover = dynamic_cast<const TRestRawSignalRecoverChannelsProcess*>(shared.back().get());
+                if (recover) nChannels = recover->GetChannelIds().size();
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            std::string name = std::string(key->GetClassName()) + " v" +
+                               std::to_string(versions[key->GetClassName()]) +
+                               (nChannels >= 0 ? " channels=" + std::to_string(nChannels) : "");
+            Group& group = groups[name];
+            group.fObjects++;
+            group.fSeconds += std::chrono::duration<Double_t>(end - start).count();
+            group.fAllocations += gAllocations - allocationsStart;
+            nObjects++;
+        }
+    }
+    Long64_t resident = GetResidentMemory() - residentStart;
+
+    for (const auto& group : groups) {
+        std::cout << "{\"benchmark\": \"legacyIO\", \"scenario\": \"" << scenario << "\", \"method\": \""
+                  << method << "\", \"files\": " << files.size() << ", \"class\": \"" << group.first
+                  << "\", \"objects\": " << group.second.fObjects
+                  << ", \"secondsPerObject\": " << group.second.fSeconds / group.second.fObjects
+                  << ", \"allocationsPerObject\": "
+                  << (double)group.second.fAllocations / group.second.fObjects << "}" << std::endl;
+    }
+    std::cout << "{\"benchmark\": \"legacyIO\", \"scenario\": \"" << scenario << "\", \"method\": \""
+              << method << "\", \"files\": " << files.size() << ", \"objects\": " << nObjects
+              << ", \"openSecondsPerFile\": " << openSeconds / std::max<size_t>(files.size(), 1)
+              << ", \"residentBytesPerObject\": " << (double)resident / std::max<Long64_t>(nObjects, 1) << "}"
+              << std::endl;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    for (int n = 1; n < argc; n++) {
+        std::string arg = argv[n];
+        size_t equal = arg.find('=');
+        if (equal == std::string::npos || gOptions.count(arg.substr(0, equal)) == 0) {
+            std::cerr << "Unknown option " << arg << ". See the header of legacyIO.cxx" << std::endl;
+            return 1;
+        }
+        gOptions[arg.substr(0, equal)] = arg.substr(equal + 1);
+    }
+
+    std::vector<std::string> files;
+    const std::string input = gOptions["input"];
+    if (input.empty()) {
+        files = GenerateFixtures();
+    } else if (input[0] == '@') {
+        std::ifstream list(input.substr(1));
+        for (std::string line; std::getline(list, line);)
+            if (!line.empty()) files.push_back(line);
+    } else {
+        files = Split(input);
+    }
+    if (files.empty() || !CheckChannelCounts(files)) return 1;
+
+    for (const auto& method : {"readObj", "streamer", "pool"}) {
+        Read("single", method, {files[0]});
+        Read("chain", method, files);
+    }
+    return 0;
+}
@@ -0,0 +1,395 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Throughput benchmark of the legacy zero suppression and channel recovery algorithms, on synthetic
+// raw signals.
+//
+// restLegacyKernelBenchmark [OPTION=VALUE]...
+//
+//   channels=2048        Number of signals per event
+//   bins=512             Number of bins per signal
+//   events=20            Number of events generated
+//   repetitions=5        Number of times each benchmark is repeated, the best time is kept
+//   baseline=250         Baseline ADC value
+//   noise=10             Sigma of the gaussian noise, in ADC units
+//   shape=aget           Pulse shape: aget (semi-gaussian shaper), gauss or square
+//   width=40             Pulse width, in bins
+//   amplitude=600        Mean pulse amplitude, in ADC units
+//   occupancy=0.05       Fraction of signals containing a pulse
+//   dead=0.01            Fraction of dead channels, recovered from their two neighbours
+//   batch=20             Number of events recovered together by the channel recovery benchmark
+//   thresholds=3,5       Point thresholds used for the zero suppression configurations
+//   seed=1               Seed of the random generator
+//
+// Each benchmark prints one JSON object per line, including the throughput (samples and events per
+// second), the heap allocations per event and, when the kernel allows it, the last level cache misses
+// per sample. Cache misses are counted on the main thread only, so for the parallel configurations they
+// do not include the work done by the pool threads. Unavailable counters are given as null.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "TRestLegacyChannelRecovery.h"
+#include "TRestLegacySpecializedZeroSuppression.h"
+#include "TRestLegacyStreamingZeroSuppression.h"
+#include "TRestLegacyTaskPool.h"
+#include "TRestLegacyZeroSuppression.h"
+#include "TRestLegacyZeroSuppressionSweep.h"
+
+namespace {
+std::atomic<unsigned long long> gAllocations(0);
+}
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+/// The options given in the command line, with their default values
+std::map<std::string, std::string> gOptions = {
+    {"channels", "2048"}, {"bins", "512"},      {"events", "20"},      {"repetitions", "5"},
+    {"baseline", "250"},  {"noise", "10"},      {"shape", "aget"},     {"width", "40"},
+    {"amplitude", "600"}, {"occupancy", "0.05"}, {"dead", "0.01"},     {"thresholds", "3,5"},
+    {"batch", "20"},      {"seed", "1"}};
+
+double GetOption(const std::string& name) { return std::atof(gOptions[name].c_str()); }
+
+std::string ToString(double value) {
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+/// The last level cache misses of the calling thread, if the kernel gives access to them. Threads
+/// already running, such as those of the task pool, are not counted.
+class CacheCounter {
+   private:
+    int fDescriptor = -1;
+
+   public:
+    CacheCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fDescriptor = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheCounter() {
+#ifdef __linux__
+        if (fDescriptor >= 0) close(fDescriptor);
+#endif
+    }
+
+    bool IsAvailable() const { return fDescriptor >= 0; }
+
+    void Start() {
+#ifdef __linux__
+        if (fDescriptor < 0) return;
+        ioctl(fDescriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long Stop() {
+        long long count = 0;
+#ifdef __linux__
+        if (fDescriptor < 0) return -1;
+        ioctl(fDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fDescriptor, &count, sizeof(count)) != sizeof(count)) return -1;
+#endif
+        return count;
+    }
+};
+
+/// A set of synthetic events, each one with the same number of signals and bins
+struct Events {
+    Int_t fNEvents;
+    Int_t fNChannels;
+    Int_t fNBins;
+    /// ADC values, signal after signal, event after event
+    std::vector<Short_t> fData;
+    /// The signal id of each channel, and the ids of the dead channels
+    std::vector<Int_t> fSignalIds;
+    std::vector<Int_t> fDeadIds;
+
+    const Short_t* GetSignal(Int_t event, Int_t channel) const {
+        return fData.data() + ((size_t)event * fNChannels + channel) * fNBins;
+    }
+};
+
+/// The pulse shape, normalized to a maximum of 1, at `t` bins after the pulse start
+double GetPulseShape(const std::string& shape, double t, double width) {
+    if (t < 0) return 0;
+    if (shape == "square") return t < width ? 1 : 0;
+    if (shape == "gauss") return std::exp(-0.5 * std::pow((t - 2 * width) / (width / 2), 2));
+    // Semi-gaussian shaper of order 3, peaking at t = width
+    double x = t / width;
+    return std::pow(x, 3) * std::exp(3 * (1 - x));
+}
+
+Events Generate() {
+    Events events;
+    events.fNEvents = GetOption("events");
+    events.fNChannels = GetOption("channels");
+    events.fNBins = GetOption("bins");
+    events.fData.resize((size_t)events.fNEvents * events.fNChannels * events.fNBins);
+
+    std::mt19937 random(GetOption("seed"));
+    std::normal_distribution<double> noise(GetOption("baseline"), GetOption("noise"));
+    std::exponential_distribution<double> amplitude(1. / GetOption("amplitude"));
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const std::string shape = gOptions["shape"];
+    const double width = GetOption("width");
+
+    for (Int_t c = 0; c < events.fNChannels; c++) {
+        events.fSignalIds.push_back(c);
+        if (c > 0 && c < events.fNChannels - 1 && uniform(random) < GetOption("dead"))
+            events.fDeadIds.push_back(c);
+    }
+
+    for (Int_t e = 0; e < events.fNEvents; e++) {
+        for (Int_t c = 0; c < events.fNChannels; c++) {
+            Short_t* signal = events.fData.data() + ((size_t)e * events.fNChannels + c) * events.fNBins;
+            if (std::binary_search(events.fDeadIds.begin(), events.fDeadIds.end(), c)) continue;
+
+            bool pulse = uniform(random) < GetOption("occupancy");
+            double start = uniform(random) * events.fNBins * 0.7;
+            double height = amplitude(random);
+            for (Int_t b = 0; b < events.fNBins; b++) {
+                double value = noise(random);
+                if (pulse) value += height * GetPulseShape(shape, b - start, width);
+                signal[b] = (Short_t)std::max(-32768., std::min(32767., std::round(value)));
+            }
+        }
+    }
+    return events;
+}
+
+std::vector<double> GetThresholds() {
+    std::vector<double> thresholds;
+    std::stringstream list(gOptions["thresholds"]);
+    for (std::string value; std::getline(list, value, ',');) thresholds.push_back(std::atof(value.c_str()));
+    return thresholds;
+}
+
+/// It runs `body` over all the events, `repetitions` times, and prints the best repetition
+void Measure(const std::string& benchmark, const std::string& configuration, const Events& events,
+             const std::function<void(Int_t event)>& body) {
+    const Int_t repetitions = std::max(1., GetOption("repetitions"));
+    CacheCounter cache;
+
+    // One warm-up pass, so that buffers reused between events are already allocated
+    body(0);
+
+    double best = 1e300;
+    unsigned long long allocations = 0;
+    long long misses = -1;
+    for (Int_t r = 0; r < repetitions; r++) {
+        unsigned long long allocationsStart = gAllocations;
+        cache.Start();
+        auto start = std::chrono::steady_clock::now();
+        for (Int_t e = 0; e < events.fNEvents; e++) body(e);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long repetitionMisses = cache.Stop();
+        if (time < best) {
+            best = time;
+            allocations = gAllocations - allocationsStart;
+            misses = repetitionMisses;
+        }
+    }
+
+    double samples = (double)events.fNEvents * events.fNChannels * events.fNBins;
+    std::cout << "{\"benchmark\": \"" << benchmark << "\", \"configuration\": \"" << configuration
+              << "\", \"channels\": " << events.fNChannels << ", \"bins\": " << events.fNBins
+              << ", \"events\": " << events.fNEvents << ", \"seconds\": " << best
+              << ", \"samplesPerSecond\": " << samples / best
+              << ", \"eventsPerSecond\": " << events.fNEvents / best
+              << ", \"allocationsPerEvent\": " << (double)allocations / events.fNEvents
+              << ", \"mainThreadCacheMissesPerSample\": ";
+    if (misses >= 0)
+        std::cout << misses / samples;
+    else
+        std::cout << "null";
+    std::cout << "}" << std::endl;
+}
+
+void BenchmarkZeroSuppression(const Events& events) {
+    std::vector<Int_t> points;
+    for (double threshold : GetThresholds()) {
+        TRestLegacyZeroSuppression::Parameters parameters;
+        parameters.fPointThreshold = threshold;
+        parameters.fIntegralEnd = events.fNBins;
+
+        using Kernel = TRestLegacyZeroSuppression::Kernel;
+        for (auto kernel : {Kernel::kScalar, Kernel::kSSE, Kernel::kAVX2}) {
+            if (!TRestLegacyZeroSuppression::IsKernelSupported(kernel)) continue;
+            std::string configuration =
+                TRestLegacyZeroSuppression::GetKernelName(kernel) + " pointThreshold=" + ToString(threshold);
+            Measure("zeroSuppression", configuration, events, [&](Int_t e) {
+                for (Int_t c = 0; c < events.fNChannels; c++)
+                    TRestLegacyZeroSuppression::Suppress(events.GetSignal(e, c), events.fNBins, parameters,
+                                                         points, kernel);
+            });
+        }
+
+        // The default ranges of the legacy process, which have a specialized kernel for 512 bins
+        TRestLegacyZeroSuppression::Parameters defaults;
+        defaults.fPointThreshold = threshold;
+        TRestLegacySpecializedZeroSuppression specialized(defaults, events.fNBins);
+        std::string configuration = std::string(specialized.IsSpecialized() ? "specialized" : "generic") +
+                                    " pointThreshold=" + ToString(threshold);
+        Measure("specializedZeroSuppression", configuration, events, [&](Int_t e) {
+            for (Int_t c = 0; c < events.fNChannels; c++)
+                specialized.Suppress(events.GetSignal(e, c), events.fNBins, points);
+        });
+        Measure("specializedZeroSuppression", "reference pointThreshold=" + ToString(threshold), events,
+                [&](Int_t e) {
+                    for (Int_t c = 0; c < events.fNChannels; c++)
+                        TRestLegacyZeroSuppression::Suppress(events.GetSignal(e, c), events.fNBins, defaults,
+                                                             points);
+                });
+
+        size_t nPoints = 0;
+        auto count = [&nPoints](Long64_t, const Short_t*, Int_t n) { nPoints += n; };
+        TRestLegacyStreamingZeroSuppression zs(parameters, count);
+        for (Int_t chunk : {64, 4096}) {
+            std::string configuration =
+                "chunk=" + std::to_string(chunk) + " pointThreshold=" + ToString(threshold);
+            Measure("streamingZeroSuppression", configuration, events, [&](Int_t e) {
+                for (Int_t c = 0; c < events.fNChannels; c++) {
+                    const Short_t* signal = events.GetSignal(e, c);
+                    for (Int_t b = 0; b < events.fNBins; b += chunk)
+                        zs.Process(signal + b, std::min(chunk, events.fNBins - b));
+                    zs.Finish();
+                    zs.Reset();
+                }
+            });
+        }
+    }
+
+    TRestLegacyZeroSuppressionSweep sweep;
+    for (double threshold : GetThresholds()) {
+        TRestLegacyZeroSuppression::Parameters parameters;
+        parameters.fPointThreshold = threshold;
+        parameters.fIntegralEnd = events.fNBins;
+        sweep.AddConfiguration("threshold" + ToString(threshold), parameters);
+    }
+
+    std::vector<const Short_t*> data(events.fNChannels);
+    std::vector<Int_t> nBins(events.fNChannels, events.fNBins);
+    Measure("zeroSuppressionSweep", "serial", events, [&](Int_t e) {
+        sweep.ClearEvent();
+        for (Int_t c = 0; c < events.fNChannels; c++)
+            sweep.ProcessSignal(events.fSignalIds[c], events.GetSignal(e, c), events.fNBins);
+    });
+    Measure("zeroSuppressionSweep",
+            "parallel threads=" + std::to_string(TRestLegacyTaskPool::Instance().GetNumberOfThreads() + 1),
+            events, [&](Int_t e) {
+                for (Int_t c = 0; c < events.fNChannels; c++) data[c] = events.GetSignal(e, c);
+                sweep.ProcessEvent(events.fSignalIds, data, nBins);
+            });
+}
+
+void BenchmarkChannelRecovery(const Events& events) {
+    TRestLegacyChannelRecovery recovery;
+    for (Int_t id : events.fDeadIds) recovery.AddTarget(id, {id - 1, id + 1});
+    recovery.Compile(events.fSignalIds);
+
+    // Batches of consecutive events, in the layout expected by TRestLegacyChannelRecovery: the samples
+    // of a channel are contiguous for all the events of the batch
+    const Int_t batchSize = std::max(1, std::min<Int_t>(GetOption("batch"), events.fNEvents));
+    const size_t length = (size_t)events.fNChannels * events.fNBins;
+    std::vector<Float_t> batches(events.fData.size());
+    for (Int_t e = 0; e < events.fNEvents; e++) {
+        Int_t first = e - e % batchSize;
+        Int_t nEvents = std::min(batchSize, events.fNEvents - first);
+        for (Int_t c = 0; c < events.fNChannels; c++) {
+            size_t offset = first * length + ((size_t)c * nEvents + e - first) * events.fNBins;
+            const Short_t* signal = events.GetSignal(e, c);
+            std::copy(signal, signal + events.fNBins, batches.begin() + offset);
+        }
+    }
+
+    // The whole batch is recovered when its first event is reached
+    auto recover = [&](Int_t e, bool parallel) {
+        if (e % batchSize != 0) return;
+        Int_t nEvents = std::min(batchSize, events.fNEvents - e);
+        if (parallel)
+            recovery.ApplyParallel(batches.data() + e * length, nEvents, events.fNBins);
+        else
+            recovery.Apply(batches.data() + e * length, nEvents, events.fNBins);
+    };
+
+    std::string configuration = "deadChannels=" + std::to_string(events.fDeadIds.size()) +
+                                " batch=" + std::to_string(batchSize);
+    Measure("channelRecovery", configuration + " serial", events, [&](Int_t e) { recover(e, false); });
+    Measure("channelRecovery", configuration + " parallel", events, [&](Int_t e) { recover(e, true); });
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    for (int n = 1; n < argc; n++) {
+        std::string arg = argv[n];
+        size_t equal = arg.find('=');
+        if (equal == std::string::npos || gOptions.count(arg.substr(0, equal)) == 0) {
+            std::cerr << "Unknown option " << arg << ". See the header of legacyKernels.cxx" << std::endl;
+            return 1;
+        }
+        gOptions[arg.substr(0, equal)] = arg.substr(equal + 1);
+    }
+
+    Events events = Generate();
+    BenchmarkZeroSuppression(events);
+    BenchmarkChannelRecovery(events);
+    return 0;
+}
@@ -0,0 +1,33 @@
+#!/bin/bash
+#
+# Measures the ROOT session startup time with and without the legacy library.
+#
+#   baseline : ROOT session where the legacy library is never loaded
+#   eager    : the legacy library is loaded at startup, as done for every restRoot session
+#   autoload : the legacy library is loaded through its rootmap, the first time a legacy class is required
+#
+# Usage: legacyStartup.sh [REPETITIONS]
+#
+# REST must be sourced (thisREST.sh). Results are printed as one JSON object per mode, with the median
+# wall time in milliseconds.
+
+REPETITIONS=${1:-20}
+ROOT_CMD="root -l -b -n -q"
+
+run() {
+    local mode=$1
+    local expression=$2
+    local times=()
+    for ((i = 0; i < REPETITIONS; i++)); do
+        local start=$(date +%s%N)
+        $ROOT_CMD -e "$expression" >/dev/null 2>&1
+        local end=$(date +%s%N)
+        times+=($(((end - start) / 1000000)))
+    done
+    local median=$(printf "%s\n" "${times[@]}" | sort -n | awk '{a[NR]=$1} END {print a[int((NR+1)/2)]}')
+    echo "{\"benchmark\": \"legacyStartup\", \"mode\": \"$mode\", \"repetitions\": $REPETITIONS, \"medianMs\": $median}"
+}
+
+run baseline '0;'
+run eager 'gSystem->Load("libRestFramework"); gSystem->Load("libRestLegacy");'
+run autoload 'TClass::GetClass("TRestRawZeroSuppresionProcess");'
@@ -0,0 +1,120 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyCatalog
+#define RestCore_TRestLegacyCatalog
+
+#include <RtypesCore.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+//! A memory-mapped index of the legacy process metadata stored in a list of run files
+class TRestLegacyCatalog {
+   public:
+    /// The legacy classes indexed by the catalog
+    enum LegacyClass : Int_t { kZeroSuppression = 1, kRecoverChannels = 2 };
+
+    /// A run file indexed by the catalog
+    struct FileEntry {
+        /// Position of the file path inside the string pool
+        UInt_t fPathOffset;
+        UInt_t fPathLength;
+        /// File size and modification time at the moment it was scanned
+        Long64_t fSize;
+        Long64_t fModificationTime;
+        /// The records of this file are [fFirstRecord, fFirstRecord + fNRecords)
+        Int_t fFirstRecord;
+        Int_t fNRecords;
+    };
+
+    /// The data members of a legacy process object found in a run file
+    struct Record {
+        Int_t fFile;
+        Int_t fClass;
+        /// Position of the object name inside the string pool
+        UInt_t fNameOffset;
+        UInt_t fNameLength;
+        /// TRestRawZeroSuppresionProcess members
+        Double_t fBaseLineRange[2];
+        Double_t fIntegralRange[2];
+        Double_t fPointThreshold;
+        Double_t fSignalThreshold;
+        Double_t fSampling;
+        Int_t fNPointsOverThreshold;
+        Int_t fNPointsFlatThreshold;
+        Int_t fBaseLineCorrection;
+        /// TRestRawSignalRecoverChannelsProcess members, positions inside the channel pool
+        Int_t fChannelOffset;
+        Int_t fNChannels;
+    };
+
+   private:
+    /// The path of the index file currently mapped
+    std::string fIndexFile;
+
+    /// The memory-mapped index file
+    void* fMappedData = nullptr;  //!
+    size_t fMappedSize = 0;       //!
+
+    const FileEntry* fFiles = nullptr;   //!
+    const Record* fRecords = nullptr;    //!
+    const Int_t* fChannels = nullptr;    //!
+    const char* fStrings = nullptr;      //!
+    Int_t fNFiles = 0;                   //!
+    Int_t fNRecords = 0;                 //!
+
+    void Unmap();
+
+   public:
+    bool Open(const std::string& indexFile);
+    bool Update(const std::vector<std::string>& runFiles, const std::string& indexFile, Int_t nThreads = 0);
+
+    /// Returns the number of indexed files
+    Int_t GetNumberOfFiles() const { return fNFiles; }
+
+    /// Returns the number of indexed legacy objects
+    Int_t GetNumberOfRecords() const { return fNRecords; }
+
+    /// Returns the indexed file `n`
+    const FileEntry& GetFile(Int_t n) const { return fFiles[n]; }
+
+    /// Returns the indexed legacy object `n`
+    const Record& GetRecord(Int_t n) const { return fRecords[n]; }
+
+    std::string GetFilePath(Int_t n) const;
+    std::string GetRecordName(const Record& record) const;
+    std::vector<Int_t> GetRecordChannels(const Record& record) const;
+
+    std::vector<std::string> FindFiles(const std::function<bool(const Record&)>& selection) const;
+    std::vector<std::string> FindByBaseLineRange(Double_t start, Double_t end) const;
+    std::vector<std::string> FindByIntegralRange(Double_t start, Double_t end) const;
+    std::vector<std::string> FindByRecoveredChannel(Int_t channelId) const;
+
+    TRestLegacyCatalog() {}
+    TRestLegacyCatalog(const TRestLegacyCatalog&) = delete;
+    TRestLegacyCatalog& operator=(const TRestLegacyCatalog&) = delete;
+    ~TRestLegacyCatalog() { Unmap(); }
+};
+#endif
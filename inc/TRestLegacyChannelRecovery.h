@@ -0,0 +1,100 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyChannelRecovery
+#define RestCore_TRestLegacyChannelRecovery
+
+#include <RtypesCore.h>
+
+#include <cstddef>
+#include <vector>
+
+class TRestLegacyTaskPool;
+
+//! A sparse interpolation table recovering dead channels from their neighbours
+class TRestLegacyChannelRecovery {
+   private:
+    /// The signal id of each target channel, in the order they were added
+    std::vector<Int_t> fTargetIds;
+
+    /// The neighbour signal ids of all targets, target after target
+    std::vector<Int_t> fNeighbourIds;
+
+    /// The weights of all neighbours, target after target
+    std::vector<Float_t> fNeighbourWeights;
+
+    /// The position of the first neighbour of each target. It has one extra entry at the end.
+    std::vector<Int_t> fNeighbourOffsets = {0};
+
+    /// The batch row of each target, or -1 if the target is not in the batch. Filled by Compile.
+    std::vector<Int_t> fTargetRows;
+
+    /// The batch row of each neighbour, or -1 if the neighbour is not in the batch. Filled by Compile.
+    std::vector<Int_t> fNeighbourRows;
+
+    /// The targets in the batch, grouped in waves of targets independent of each other. Filled by Compile.
+    std::vector<std::vector<Int_t>> fWaves;
+
+    void ApplyTarget(size_t n, Float_t* batch, size_t length, size_t from, size_t to) const;
+
+   public:
+    void AddTarget(Int_t targetId, const std::vector<Int_t>& neighbourIds,
+                   const std::vector<Float_t>& weights = {});
+
+    void Compile(const std::vector<Int_t>& rowSignalIds);
+
+    void Apply(Float_t* batch, Int_t nEvents, Int_t nBins) const;
+    void ApplyTarget(size_t n, Float_t* batch, Int_t nEvents, Int_t nBins) const;
+    void ApplyParallel(Float_t* batch, Int_t nEvents, Int_t nBins, TRestLegacyTaskPool* pool = nullptr) const;
+
+    /// Returns the number of channels to be recovered
+    size_t GetNumberOfTargets() const { return fTargetIds.size(); }
+
+    /// Returns the signal id of target `n`
+    Int_t GetTargetId(size_t n) const { return fTargetIds[n]; }
+
+    /// Returns the batch row of target `n`, or -1 if it is not in the batch
+    Int_t GetTargetRow(size_t n) const { return fTargetRows[n]; }
+
+    /// Returns the number of neighbours of target `n`
+    Int_t GetNumberOfNeighbours(size_t n) const { return fNeighbourOffsets[n + 1] - fNeighbourOffsets[n]; }
+
+    /// Returns the signal id of neighbour `m` of target `n`
+    Int_t GetNeighbourId(size_t n, Int_t m) const { return fNeighbourIds[fNeighbourOffsets[n] + m]; }
+
+    /// Returns the batch row of neighbour `m` of target `n`, or -1 if it is not in the batch
+    Int_t GetNeighbourRow(size_t n, Int_t m) const { return fNeighbourRows[fNeighbourOffsets[n] + m]; }
+
+    /// Returns the weight of neighbour `m` of target `n`
+    Float_t GetNeighbourWeight(size_t n, Int_t m) const {
+        return fNeighbourWeights[fNeighbourOffsets[n] + m];
+    }
+
+    /// Returns the number of waves of independent targets. Compile must have been called before.
+    size_t GetNumberOfWaves() const { return fWaves.size(); }
+
+    /// Returns the position of a sample inside a batch with `nEvents` events of `nBins` bins
+    static size_t GetBatchIndex(Int_t row, Int_t event, Int_t bin, Int_t nEvents, Int_t nBins) {
+        return ((size_t)row * nEvents + event) * nBins + bin;
+    }
+};
+#endif
@@ -0,0 +1,82 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyMigration
+#define RestCore_TRestLegacyMigration
+
+#include <RtypesCore.h>
+
+#include <string>
+#include <vector>
+
+class TDirectory;
+
+//! Rewrites run files replacing the legacy process objects by their successor processes
+class TRestLegacyMigration {
+   public:
+    /// The outcome of the migration of a single run file
+    struct Result {
+        std::string fInput;
+        std::string fOutput;
+        bool fSuccess = false;
+        /// The reason of the failure, if any
+        std::string fMessage;
+        /// Number of legacy objects replaced by their successor
+        Int_t fNTranslated = 0;
+        /// Number of trees and other objects copied
+        Int_t fNTrees = 0;
+        Int_t fNObjects = 0;
+        Long64_t fInputBytes = 0;
+        Long64_t fOutputBytes = 0;
+        Double_t fTime = 0;
+    };
+
+   private:
+    struct MemoryBudget;
+
+    /// Number of files migrated at the same time. 0 means as many as hardware cores.
+    Int_t fNThreads = 0;
+
+    /// Maximum memory, in bytes, used by the files being migrated at the same time. 0 means no limit.
+    Long64_t fMaxMemory = 0;
+
+    /// Compression settings of the output files. Negative to keep the settings of each input file.
+    Int_t fCompression = -1;
+
+    bool CopyDirectory(TDirectory* input, TDirectory* output, Result& result) const;
+    Result MigrateFile(const std::string& input, const std::string& output, MemoryBudget* budget) const;
+
+   public:
+    void SetNumberOfThreads(Int_t nThreads) { fNThreads = nThreads; }
+    void SetMaxMemory(Long64_t bytes) { fMaxMemory = bytes; }
+    void SetCompression(Int_t settings) { fCompression = settings; }
+
+    Int_t GetNumberOfThreads() const { return fNThreads; }
+    Long64_t GetMaxMemory() const { return fMaxMemory; }
+    Int_t GetCompression() const { return fCompression; }
+
+    static Long64_t EstimateMemory(TDirectory* input, bool recompress);
+
+    Result MigrateFile(const std::string& input, const std::string& output) const;
+    std::vector<Result> Migrate(const std::vector<std::string>& inputs, const std::string& outputDir) const;
+};
+#endif
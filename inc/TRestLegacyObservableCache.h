@@ -0,0 +1,127 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyObservableCache
+#define RestCore_TRestLegacyObservableCache
+
+#include <RtypesCore.h>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TRestLegacySpecializedZeroSuppression.h"
+
+//! A memory-mapped columnar cache of the legacy zero suppression event observables
+class TRestLegacyObservableCache {
+   public:
+    /// The observables stored for each event
+    enum Observable : Int_t {
+        kNumberOfSignals,
+        kNumberOfPoints,
+        kBaseLineMean,
+        kBaseLineSigmaMean,
+        kIntegral,
+        kNObservables
+    };
+
+    /// The values of all the observables of an event
+    using Values = std::array<Double_t, kNObservables>;
+
+   private:
+    /// An event waiting to be written to the cache file
+    struct Row {
+        ULong64_t fParameterHash;
+        Int_t fRunId;
+        Int_t fEventId;
+        Values fValues;
+    };
+
+    /// The path of the cache file currently mapped
+    std::string fCacheFile;
+
+    /// The memory-mapped cache file
+    void* fMappedData = nullptr;  //!
+    size_t fMappedSize = 0;       //!
+
+    /// Pointers to the columns inside the mapped file
+    const ULong64_t* fParameterHashes = nullptr;            //!
+    std::array<const Double_t*, kNObservables> fColumns{};  //!
+    const Int_t* fRunIds = nullptr;                         //!
+    const Int_t* fEventIds = nullptr;                       //!
+    Long64_t fNRows = 0;                                    //!
+
+    /// The events added since the last Write
+    std::vector<Row> fPending;  //!
+
+    /// The zero suppression used by ComputeObservables for each trace length, and the hash of its parameters
+    std::vector<TRestLegacySpecializedZeroSuppression> fZeroSuppressions;  //!
+    ULong64_t fZeroSuppressionHash = 0;                                   //!
+
+    /// The surviving points of the signal being processed
+    std::vector<Int_t> fPoints;  //!
+
+    const TRestLegacySpecializedZeroSuppression& GetZeroSuppression(
+        const TRestLegacyZeroSuppression::Parameters& parameters, ULong64_t parameterHash, Int_t nBins);
+    void Unmap();
+    Long64_t LowerBound(ULong64_t parameterHash, Int_t runId, Int_t eventId) const;
+
+   public:
+    static std::string GetObservableName(Observable observable);
+    static ULong64_t GetParameterHash(const TRestLegacyZeroSuppression::Parameters& parameters);
+    Values ComputeObservables(const TRestLegacyZeroSuppression::Parameters& parameters,
+                              const std::vector<const Short_t*>& data, const std::vector<Int_t>& nBins);
+
+    bool Open(const std::string& cacheFile);
+    void Add(Int_t runId, Int_t eventId, ULong64_t parameterHash, const Values& values);
+    bool Write(const std::string& cacheFile);
+
+    /// Returns the number of events in the mapped cache file
+    Long64_t GetNumberOfRows() const { return fNRows; }
+
+    /// Returns the number of events added and not written yet
+    size_t GetNumberOfPendingRows() const { return fPending.size(); }
+
+    /// Returns the parameter hash of every row
+    const ULong64_t* GetParameterHashes() const { return fParameterHashes; }
+
+    /// Returns the run id of every row
+    const Int_t* GetRunIds() const { return fRunIds; }
+
+    /// Returns the event id of every row
+    const Int_t* GetEventIds() const { return fEventIds; }
+
+    /// Returns the values of an observable for every row
+    const Double_t* GetColumn(Observable observable) const { return fColumns[observable]; }
+
+    std::pair<Long64_t, Long64_t> GetRows(ULong64_t parameterHash) const;
+    std::pair<Long64_t, Long64_t> GetRows(ULong64_t parameterHash, Int_t runId) const;
+    Long64_t Find(ULong64_t parameterHash, Int_t runId, Int_t eventId) const;
+
+    TRestLegacyObservableCache() {}
+    TRestLegacyObservableCache(const TRestLegacyObservableCache&) = delete;
+    TRestLegacyObservableCache& operator=(const TRestLegacyObservableCache&) = delete;
+    ~TRestLegacyObservableCache() { Unmap(); }
+};
+#endif
@@ -23,22 +23,109 @@
 #ifndef RestCore_TRestLegacyProcess
 #define RestCore_TRestLegacyProcess
 
+#include <TClass.h>
+#include <TDataMember.h>
+#include <TDataType.h>
+#include <TRealData.h>
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "TRestEventProcess.h"
 
 //! Base class for legacy process
 class TRestLegacyProcess : public TRestEventProcess {
-   public:
-    RESTValue GetInputEvent() const final { return RESTValue((TRestEvent*)nullptr); }
-    RESTValue GetOutputEvent() const final { return RESTValue((TRestEvent*)nullptr); }
-
-    void InitProcess() final{};
-    TRestEvent* ProcessEvent(TRestEvent* eventInput) final {
-        RESTError << "You are trying to execute a legacy process" << RESTendl;
-        RESTError << "This is not allow, this class is kept for backward compatibility" << RESTendl;
-        exit(1);
-        return nullptr;
+   private:
+    /// The process instance, implementing the legacy algorithm, to which event processing is forwarded
+    mutable TRestEventProcess* fSuccessor = nullptr;  //!
+
+    /// Whether the legacy data members have been translated into the successor
+    mutable bool fSuccessorTranslated = false;  //!
+
+    struct LegacyClassEntry;
+    static std::map<std::string, LegacyClassEntry, std::less<>>& GetRegistry();
+
+    TRestEventProcess* InstantiateSuccessor() const;
+    TRestEventProcess* TranslateSuccessor() const;
+    void ForwardContext(TRestEventProcess* successor);
+
+    static bool RegisterSuccessor(const std::string& legacyName, const std::string& successorName);
+
+   protected:
+    static void CountInstance(const char* legacyName);
+
+    /// It translates the legacy data members into the successor process. Implemented by each legacy process.
+    virtual void TranslateMembers(TRestEventProcess* successor) const {}
+
+    /// It assigns `value` to the data member `name` of the successor, if it exists with the same type.
+    /// Members inherited from the successor base classes, such as those of TRestEventProcess, are found.
+    template <typename T>
+    bool SetSuccessorMember(TRestEventProcess* successor, const std::string& name, const T& value) const {
+        TRealData* realData = successor->IsA()->GetRealData(name.c_str());
+        TDataMember* member = realData != nullptr ? realData->GetDataMember() : nullptr;
+        if (member == nullptr) {
+            RESTWarning << GetName() << " : " << successor->ClassName() << " has no member " << name
+                        << ". Legacy parameter will be ignored" << RESTendl;
+            return false;
+        }
+
+        bool sameType = false;
+        if (member->IsBasic())
+            sameType = member->GetDataType()->GetType() == TDataType::GetType(typeid(T));
+        else
+            sameType = TClass::GetClass(typeid(T)) == TClass::GetClass(member->GetTrueTypeName());
+
+        if (!sameType) {
+            RESTWarning << GetName() << " : " << successor->ClassName() << "::" << name
+                        << " type mismatch. Legacy parameter will be ignored" << RESTendl;
+            return false;
+        }
+
+        *reinterpret_cast<T*>(reinterpret_cast<char*>(successor) + realData->GetThisOffset()) = value;
+        return true;
+    }
+
+    /// It appends the raw bytes of a value to a content string. See AppendContent.
+    template <typename T>
+    static void AppendContentValue(std::string& content, const T& value) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        content.append(bytes, sizeof(T));
     }
-    void EndProcess() final{};
+
+   public:
+    virtual void AppendContent(std::string& content) const;
+
+    /// It registers the successor of a legacy class. Defined at namespace scope in the legacy process
+    /// source file, so that the registry is complete after static initialization.
+    struct SuccessorRegistration {
+        SuccessorRegistration(const char* legacyName, const char* successorName) {
+            RegisterSuccessor(legacyName, successorName);
+        }
+    };
+
+    static std::string GetSuccessorName(const std::string& legacyName);
+
+    static std::vector<std::pair<std::string, ULong64_t>> GetInstanceCounts();
+    static ULong64_t GetNumberOfReaderFiles();
+    static Double_t GetReaderStreamingTime();
+    static void AddReaderFile();
+    static void AddReaderStreamingTime(Double_t seconds);
+    static void PrintUsageSummary();
+
+    /// Returns the successor process with the legacy parameters, or nullptr if it could not be instantiated
+    TRestEventProcess* GetSuccessor() const { return TranslateSuccessor(); }
+
+    RESTValue GetInputEvent() const final;
+    RESTValue GetOutputEvent() const final;
+
+    void InitProcess() final;
+    TRestEvent* ProcessEvent(TRestEvent* eventInput) final;
+    void EndProcess() final;
 
     /// It prints out the process parameters stored in the metadata structure
     void PrintMetadata() override {}
@@ -48,7 +135,7 @@ class TRestLegacyProcess : public TRestEventProcess {
 
     TRestLegacyProcess() {}
     TRestLegacyProcess(char* cfgFileName) {}
-    ~TRestLegacyProcess() {}
+    ~TRestLegacyProcess();
 
     ClassDefOverride(TRestLegacyProcess, 0);
 };
@@ -0,0 +1,54 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyProcessPool
+#define RestCore_TRestLegacyProcessPool
+
+#include <RtypesCore.h>
+
+#include <memory>
+#include <string>
+
+class TFile;
+class TRestLegacyProcess;
+
+//! A pool sharing a single instance among identical legacy process objects
+class TRestLegacyProcessPool {
+   private:
+    struct State;
+
+    /// The pool contents. It is kept alive by the shared objects, which may outlive the pool.
+    std::shared_ptr<State> fState;  //!
+
+    TRestLegacyProcessPool();
+
+   public:
+    static TRestLegacyProcessPool& Instance();
+
+    std::shared_ptr<const TRestLegacyProcess> Intern(TRestLegacyProcess* process);
+    std::shared_ptr<const TRestLegacyProcess> Read(TFile* file, const std::string& name);
+
+    size_t GetNumberOfObjects() const;
+    ULong64_t GetNumberOfRequests() const;
+    ULong64_t GetNumberOfHits() const;
+};
+#endif
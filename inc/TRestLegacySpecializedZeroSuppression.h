@@ -0,0 +1,87 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacySpecializedZeroSuppression
+#define RestCore_TRestLegacySpecializedZeroSuppression
+
+#include <RtypesCore.h>
+
+#include <vector>
+
+#include "TRestLegacyZeroSuppression.h"
+
+//! Legacy zero suppression dispatched to kernels compiled for common parameter sets
+class TRestLegacySpecializedZeroSuppression {
+   public:
+    /// The values fixed at compile time in a specialized kernel
+    struct Specialization {
+        Int_t fNBins;
+        Int_t fBaseLineStart;
+        Int_t fBaseLineEnd;
+        Int_t fIntegralStart;
+        Int_t fIntegralEnd;
+        Int_t fNPointsOverThreshold;
+    };
+
+    /// A specialized kernel. The trace length, ranges and number of points are those of its Specialization.
+    using Function = TRestLegacyZeroSuppression::BaseLine (*)(
+        const Short_t* data, const TRestLegacyZeroSuppression::Parameters& parameters,
+        std::vector<Int_t>& points);
+
+   private:
+    /// The zero suppression parameters
+    TRestLegacyZeroSuppression::Parameters fParameters;
+
+    /// The trace length the kernel was selected for
+    Int_t fNBins = 0;
+
+    /// The specialized kernel, or nullptr if the generic kernel is used
+    Function fFunction = nullptr;
+
+    /// The generic kernel, used for traces of other lengths or when no specialization matches
+    TRestLegacyZeroSuppression::Kernel fKernel = TRestLegacyZeroSuppression::GetBestKernel();
+
+   public:
+    static const std::vector<Specialization>& GetSpecializations();
+    static Function FindSpecialization(const TRestLegacyZeroSuppression::Parameters& parameters, Int_t nBins);
+
+    /// Returns true if a specialized kernel is used for traces of GetNumberOfBins bins
+    bool IsSpecialized() const { return fFunction != nullptr; }
+
+    /// Returns the trace length the kernel was selected for
+    Int_t GetNumberOfBins() const { return fNBins; }
+
+    /// Returns the zero suppression parameters
+    const TRestLegacyZeroSuppression::Parameters& GetParameters() const { return fParameters; }
+
+    /// It calculates the baseline and fills `points` as TRestLegacyZeroSuppression::Suppress does
+    TRestLegacyZeroSuppression::BaseLine Suppress(const Short_t* data, Int_t nBins,
+                                                  std::vector<Int_t>& points) const {
+        if (fFunction != nullptr && nBins == fNBins) return fFunction(data, fParameters, points);
+        return TRestLegacyZeroSuppression::Suppress(data, nBins, fParameters, points, fKernel);
+    }
+
+    TRestLegacySpecializedZeroSuppression(
+        const TRestLegacyZeroSuppression::Parameters& parameters, Int_t nBins,
+        TRestLegacyZeroSuppression::Kernel kernel = TRestLegacyZeroSuppression::GetBestKernel());
+};
+#endif
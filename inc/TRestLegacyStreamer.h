@@ -0,0 +1,63 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyStreamer
+#define RestCore_TRestLegacyStreamer
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TRestLegacyCatalog.h"
+
+class TBuffer;
+class TFile;
+class TKey;
+class TStreamerElement;
+
+//! Decodes legacy process objects stored in a file directly into flat records
+class TRestLegacyStreamer {
+   private:
+    /// A decoding step, corresponding to one element of the on-file streamer info
+    struct Step {
+        Int_t fKind;
+        Int_t fField;
+        TStreamerElement* fElement;
+    };
+
+    /// Reusable buffers for the compressed key and the uncompressed object
+    std::vector<char> fKeyBuffer;     //!
+    std::vector<char> fObjectBuffer;  //!
+
+    /// The decoding steps of each class name and class version already seen
+    std::map<std::pair<std::string, Int_t>, std::vector<Step>> fPlans;  //!
+
+    const std::vector<Step>* GetPlan(const std::string& className, Int_t version);
+    bool ReadKeyBuffer(TFile* file, TKey* key);
+    bool Execute(TBuffer& buffer, const std::vector<Step>& plan, TRestLegacyCatalog::Record& record,
+                 std::vector<Int_t>& channels);
+
+   public:
+    bool Decode(TFile* file, TKey* key, TRestLegacyCatalog::Record& record, std::vector<Int_t>& channels);
+};
+#endif
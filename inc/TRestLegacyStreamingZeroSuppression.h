@@ -0,0 +1,116 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyStreamingZeroSuppression
+#define RestCore_TRestLegacyStreamingZeroSuppression
+
+#include <functional>
+#include <vector>
+
+#include "TRestLegacyZeroSuppression.h"
+
+//! Legacy zero suppression applied to a raw signal received in consecutive chunks
+class TRestLegacyStreamingZeroSuppression {
+   public:
+    /// How the baseline is calculated
+    enum class BaseLineMode {
+        /// Over the baseline range, as the legacy algorithm
+        kFixedRange,
+        /// Over a window with the last samples not belonging to a pulse
+        kSlidingWindow
+    };
+
+    /// It receives the first bin and the ADC values of each accepted pulse
+    using Callback = std::function<void(Long64_t firstBin, const Short_t* values, Int_t nValues)>;
+
+   private:
+    TRestLegacyZeroSuppression::Parameters fParameters;  //!
+    TRestLegacyZeroSuppression::Kernel fKernel;          //!
+    BaseLineMode fMode;                                  //!
+    Callback fCallback;                                  //!
+
+    /// Number of samples received since the beginning of the signal
+    Long64_t fNSamples = 0;  //!
+
+    /// Integer sums of the samples used for the baseline
+    Long64_t fBaseLineSum = 0;         //!
+    Long64_t fBaseLineSumSquares = 0;  //!
+    Int_t fNBaseLine = 0;              //!
+
+    bool fBaseLineReady = false;                     //!
+    TRestLegacyZeroSuppression::BaseLine fBaseLine;  //!
+    Double_t fThreshold = 0;                         //!
+    Double_t fSignalThreshold = 0;                   //!
+
+    /// Samples of the integral range received before the end of the fixed baseline range
+    std::vector<Short_t> fPending;  //!
+    Long64_t fPendingFirst = 0;     //!
+
+    /// The ring buffer of the sliding window
+    std::vector<Short_t> fWindow;  //!
+    Int_t fWindowSize = 0;         //!
+    Int_t fWindowPosition = 0;     //!
+
+    /// The pulse in progress
+    bool fInPulse = false;             //!
+    Long64_t fPulseFirst = 0;          //!
+    Double_t fPulseSum = 0;            //!
+    Double_t fPulseSumSquares = 0;     //!
+    Double_t fPrevious = 0;            //!
+    Int_t fNFlat = 0;                  //!
+    std::vector<Short_t> fPulse;       //!
+
+    /// Maximum number of samples of a pulse
+    Int_t fMaxPulseLength = 0;  //!
+
+    void SetThresholds();
+    void StartPulse(Long64_t bin, Short_t adc);
+    bool ContinuePulse(Short_t adc);
+    void EndPulse();
+    void AddToWindow(Short_t adc);
+    void ScanFixed(const Short_t* data, Long64_t first, Int_t n);
+    void ScanSliding(const Short_t* data, Long64_t first, Int_t n);
+
+   public:
+    void SetMaxPulseLength(Int_t maxPulseLength);
+
+    /// Returns the maximum number of samples of a pulse
+    Int_t GetMaxPulseLength() const { return fMaxPulseLength; }
+
+    void Process(const Short_t* data, Int_t nSamples);
+    void Finish();
+    void Reset();
+
+    /// Returns the number of samples received since the beginning of the signal
+    Long64_t GetNumberOfSamples() const { return fNSamples; }
+
+    /// Returns the baseline used for the last pulse search
+    TRestLegacyZeroSuppression::BaseLine GetBaseLine() const { return fBaseLine; }
+
+    size_t GetMemoryUsage() const;
+
+    TRestLegacyStreamingZeroSuppression(
+        const TRestLegacyZeroSuppression::Parameters& parameters, Callback callback,
+        BaseLineMode mode = BaseLineMode::kFixedRange, Int_t windowSize = 0,
+        TRestLegacyZeroSuppression::Kernel kernel = TRestLegacyZeroSuppression::GetBestKernel());
+};
+#endif
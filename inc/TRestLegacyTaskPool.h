@@ -0,0 +1,76 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyTaskPool
+#define RestCore_TRestLegacyTaskPool
+
+#include <RtypesCore.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! A work-stealing pool of threads executing independent tasks
+class TRestLegacyTaskPool {
+   private:
+    /// The tasks waiting to be executed by one of the threads
+    struct Queue {
+        std::mutex fMutex;
+        std::deque<std::function<void()>> fTasks;
+    };
+
+    /// One queue per thread, plus one (the last) for the tasks submitted from outside the pool
+    std::vector<std::unique_ptr<Queue>> fQueues;  //!
+    std::vector<std::thread> fThreads;            //!
+
+    std::mutex fMutex;                  //!
+    std::condition_variable fWakeUp;    //!
+    std::condition_variable fFinished;  //!
+    std::atomic<size_t> fNQueued{0};    //!
+    bool fStop = false;                 //!
+
+    size_t GetCurrentQueue() const;
+    void Push(std::function<void()> task);
+    bool RunOne(size_t queue);
+    void Work(size_t queue);
+
+   public:
+    static TRestLegacyTaskPool& Instance();
+
+    void ParallelFor(size_t nItems, const std::function<void(size_t)>& body, size_t grain = 1);
+
+    /// Returns the number of threads of the pool
+    Int_t GetNumberOfThreads() const { return fThreads.size(); }
+
+    explicit TRestLegacyTaskPool(Int_t nThreads = 0);
+    ~TRestLegacyTaskPool();
+
+    TRestLegacyTaskPool(const TRestLegacyTaskPool&) = delete;
+    TRestLegacyTaskPool& operator=(const TRestLegacyTaskPool&) = delete;
+};
+#endif
@@ -0,0 +1,83 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyZeroSuppression
+#define RestCore_TRestLegacyZeroSuppression
+
+#include <RtypesCore.h>
+
+#include <string>
+#include <vector>
+
+//! Standalone implementation of the legacy zero suppression algorithm on raw ADC data
+class TRestLegacyZeroSuppression {
+   public:
+    /// The legacy zero suppression parameters, ranges given in number of bins
+    struct Parameters {
+        /// First bin of the baseline range
+        Int_t fBaseLineStart = 5;
+        /// Last bin (excluded) of the baseline range
+        Int_t fBaseLineEnd = 55;
+        /// First bin of the integral range
+        Int_t fIntegralStart = 10;
+        /// Last bin (excluded) of the integral range
+        Int_t fIntegralEnd = 500;
+        /// Number of baseline sigmas for a point to be over threshold
+        Double_t fPointThreshold = 5;
+        /// Number of baseline sigmas the pulse standard deviation must exceed
+        Double_t fSignalThreshold = 5;
+        /// Minimum number of consecutive points over threshold
+        Int_t fNPointsOverThreshold = 5;
+        /// Maximum number of consecutive flat points before a pulse is ended
+        Int_t fNPointsFlatThreshold = 512;
+    };
+
+    /// The baseline properties of a raw signal
+    struct BaseLine {
+        Double_t fMean = 0;
+        Double_t fSigma = 0;
+    };
+
+    /// The available implementations. All of them produce bit-identical results.
+    enum class Kernel { kScalar, kSSE, kAVX2 };
+
+    static Kernel GetBestKernel();
+    static bool IsKernelSupported(Kernel kernel);
+    static std::string GetKernelName(Kernel kernel);
+
+    static BaseLine GetBaseLine(Long64_t sum, Long64_t sumSquares, Int_t n);
+    static Int_t GetMinimumADCOverThreshold(Double_t mean, Double_t threshold);
+
+    static BaseLine ComputeBaseLine(const Short_t* data, Int_t nBins, Int_t start, Int_t end,
+                                    Kernel kernel = GetBestKernel());
+
+    static Int_t FindPointOverThreshold(const Short_t* data, Int_t from, Int_t to, const BaseLine& baseLine,
+                                        Double_t pointThreshold, Kernel kernel = GetBestKernel());
+
+    static void GetPointsOverThreshold(const Short_t* data, Int_t nBins, const Parameters& parameters,
+                                       const BaseLine& baseLine, std::vector<Int_t>& points,
+                                       Kernel kernel = GetBestKernel());
+
+    static BaseLine Suppress(const Short_t* data, Int_t nBins, const Parameters& parameters,
+                             std::vector<Int_t>& points, Kernel kernel = GetBestKernel());
+};
+#endif
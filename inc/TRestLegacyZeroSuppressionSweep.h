@@ -0,0 +1,98 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestLegacyZeroSuppressionSweep
+#define RestCore_TRestLegacyZeroSuppressionSweep
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TRestLegacyZeroSuppression.h"
+
+class TRestLegacyTaskPool;
+class TTree;
+
+//! Applies several legacy zero suppression configurations in a single pass over the raw data
+class TRestLegacyZeroSuppressionSweep {
+   private:
+    /// The name of each configuration, used as output branch prefix
+    std::vector<std::string> fNames;
+
+    /// The zero suppression parameters of each configuration
+    std::vector<TRestLegacyZeroSuppression::Parameters> fConfigurations;
+
+    /// The distinct baseline ranges used by the configurations
+    std::vector<std::pair<Int_t, Int_t>> fBaseLineRanges;
+
+    /// The index, inside fBaseLineRanges, of the baseline range of each configuration
+    std::vector<size_t> fBaseLineRangeIndex;
+
+    /// The baselines of the signal being processed, one per distinct baseline range
+    std::vector<TRestLegacyZeroSuppression::BaseLine> fBaseLines;
+
+    /// The surviving points of the signal being processed
+    std::vector<Int_t> fPoints;
+
+    /// The signal id of each surviving point in the current event, for each configuration
+    std::vector<std::vector<Int_t>> fSignalIds;
+
+    /// The bin of each surviving point in the current event, for each configuration
+    std::vector<std::vector<Int_t>> fBins;
+
+    /// The surviving points of each signal and configuration, filled in parallel by ProcessEvent
+    std::vector<std::vector<Int_t>> fSignalPoints;
+
+    /// The kernel used for the calculations
+    TRestLegacyZeroSuppression::Kernel fKernel = TRestLegacyZeroSuppression::GetBestKernel();
+
+   public:
+    size_t AddConfiguration(const std::string& name,
+                            const TRestLegacyZeroSuppression::Parameters& parameters);
+
+    /// Returns the number of configurations
+    size_t GetNumberOfConfigurations() const { return fConfigurations.size(); }
+
+    /// Returns the number of distinct baseline ranges, i.e. baselines calculated per signal
+    size_t GetNumberOfBaseLineRanges() const { return fBaseLineRanges.size(); }
+
+    /// Returns the name of configuration `n`
+    const std::string& GetName(size_t n) const { return fNames[n]; }
+
+    /// Returns the parameters of configuration `n`
+    const TRestLegacyZeroSuppression::Parameters& GetParameters(size_t n) const { return fConfigurations[n]; }
+
+    /// Returns the signal ids of the points surviving configuration `n` in the current event
+    const std::vector<Int_t>& GetSignalIds(size_t n) const { return fSignalIds[n]; }
+
+    /// Returns the bins of the points surviving configuration `n` in the current event
+    const std::vector<Int_t>& GetBins(size_t n) const { return fBins[n]; }
+
+    void SetKernel(TRestLegacyZeroSuppression::Kernel kernel) { fKernel = kernel; }
+
+    void ClearEvent();
+    void ProcessSignal(Int_t signalId, const Short_t* data, Int_t nBins);
+    void ProcessEvent(const std::vector<Int_t>& signalIds, const std::vector<const Short_t*>& data,
+                      const std::vector<Int_t>& nBins, TRestLegacyTaskPool* pool = nullptr);
+    void CreateBranches(TTree* tree);
+};
+#endif
@@ -23,6 +23,10 @@
 #ifndef RestCore_TRestRawSignalRecoverChannelsProcess
 #define RestCore_TRestRawSignalRecoverChannelsProcess
 
+#include <functional>
+#include <utility>
+
+#include "TRestLegacyChannelRecovery.h"
 #include "TRestLegacyProcess.h"
 
 //! A process allowing to recover selected channels from a TRestRawSignalEvent
@@ -30,7 +34,34 @@ class TRestRawSignalRecoverChannelsProcess : public TRestLegacyProcess {
    private:
     std::vector<Int_t> fChannelIds;  //<
 
+   protected:
+    void TranslateMembers(TRestEventProcess* successor) const override {
+        SetSuccessorMember(successor, "fChannelIds", fChannelIds);
+    }
+
    public:
+    void AppendContent(std::string& content) const override {
+        TRestLegacyProcess::AppendContent(content);
+        AppendContentValue(content, fChannelIds.size());
+        for (const auto& channelId : fChannelIds) AppendContentValue(content, channelId);
+    }
+
+    /// Returns the signal ids of the channels to recover
+    const std::vector<Int_t>& GetChannelIds() const { return fChannelIds; }
+
+    /// It builds the recovery table of the legacy rule, \f$s_i = 0.5 \times (s_{i-1} + s_{i+1})\f$.
+    /// `adjacentIds` returns the signal ids at the left and right of a given signal id, i.e. the
+    /// readout lookup. It is called only once per channel.
+    TRestLegacyChannelRecovery GetChannelRecovery(
+        const std::function<std::pair<Int_t, Int_t>(Int_t)>& adjacentIds) const {
+        TRestLegacyChannelRecovery recovery;
+        for (const auto& channelId : fChannelIds) {
+            std::pair<Int_t, Int_t> adjacent = adjacentIds(channelId);
+            recovery.AddTarget(channelId, {adjacent.first, adjacent.second});
+        }
+        return recovery;
+    }
+
     void PrintMetadata() override {
         BeginPrintProcess();
         for (const auto& channelId : fChannelIds) {
@@ -39,14 +70,10 @@ class TRestRawSignalRecoverChannelsProcess : public TRestLegacyProcess {
         EndPrintProcess();
     }
 
-    TRestRawSignalRecoverChannelsProcess() {
-        RESTWarning << "Creating legacy process TRestRawSignalRecoverChannelsProcess" << RESTendl;
-        RESTWarning << "This process is now implemented under TRestDetectorSignalRecoveryProcess" << RESTendl;
-    }
+    TRestRawSignalRecoverChannelsProcess() { CountInstance("TRestRawSignalRecoverChannelsProcess"); }
 
     TRestRawSignalRecoverChannelsProcess(char* configFilename) {
-        RESTWarning << "Creating legacy process TRestRawSignalRecoverChannelsProcess" << RESTendl;
-        RESTWarning << "This process is now implemented under TRestDetectorSignalRecoveryProcess" << RESTendl;
+        CountInstance("TRestRawSignalRecoverChannelsProcess");
     }
 
     ClassDefOverride(TRestRawSignalRecoverChannelsProcess, 1);
@@ -24,6 +24,7 @@
 #define RestCore_TRestRawZeroSuppresionProcess
 
 #include "TRestLegacyProcess.h"
+#include "TRestLegacyZeroSuppression.h"
 
 //! A process to identify signal and remove baseline noise from a TRestRawSignalEvent.
 class TRestRawZeroSuppresionProcess : public TRestLegacyProcess {
@@ -52,7 +53,57 @@ class TRestRawZeroSuppresionProcess : public TRestLegacyProcess {
     /// Given in us.
     Double_t fSampling;
 
+   protected:
+    void TranslateMembers(TRestEventProcess* successor) const override {
+        SetSuccessorMember(successor, "fZeroSuppression", true);
+        SetSuccessorMember(successor, "fBaseLineRange", fBaseLineRange);
+        SetSuccessorMember(successor, "fIntegralRange", fIntegralRange);
+        SetSuccessorMember(successor, "fPointThreshold", fPointThreshold);
+        SetSuccessorMember(successor, "fSignalThreshold", fSignalThreshold);
+        SetSuccessorMember(successor, "fNPointsOverThreshold", fNPointsOverThreshold);
+        SetSuccessorMember(successor, "fNPointsFlatThreshold", fNPointsFlatThreshold);
+        SetSuccessorMember(successor, "fBaseLineCorrection", fBaseLineCorrection);
+        SetSuccessorMember(successor, "fSampling", fSampling);
+    }
+
    public:
+    void AppendContent(std::string& content) const override {
+        TRestLegacyProcess::AppendContent(content);
+        AppendContentValue(content, fBaseLineRange.X());
+        AppendContentValue(content, fBaseLineRange.Y());
+        AppendContentValue(content, fIntegralRange.X());
+        AppendContentValue(content, fIntegralRange.Y());
+        AppendContentValue(content, fPointThreshold);
+        AppendContentValue(content, fSignalThreshold);
+        AppendContentValue(content, fNPointsOverThreshold);
+        AppendContentValue(content, fNPointsFlatThreshold);
+        AppendContentValue(content, fBaseLineCorrection);
+        AppendContentValue(content, fSampling);
+    }
+
+    TVector2 GetBaseLineRange() const { return fBaseLineRange; }
+    TVector2 GetIntegralRange() const { return fIntegralRange; }
+    Double_t GetPointThreshold() const { return fPointThreshold; }
+    Double_t GetSignalThreshold() const { return fSignalThreshold; }
+    Int_t GetNPointsOverThreshold() const { return fNPointsOverThreshold; }
+    Int_t GetNPointsFlatThreshold() const { return fNPointsFlatThreshold; }
+    Bool_t GetBaseLineCorrection() const { return fBaseLineCorrection; }
+    Double_t GetSampling() const { return fSampling; }
+
+    /// It returns the stored parameters in the form used by the TRestLegacyZeroSuppression kernels
+    TRestLegacyZeroSuppression::Parameters GetZeroSuppressionParameters() const {
+        TRestLegacyZeroSuppression::Parameters parameters;
+        parameters.fBaseLineStart = (Int_t)fBaseLineRange.X();
+        parameters.fBaseLineEnd = (Int_t)fBaseLineRange.Y();
+        parameters.fIntegralStart = (Int_t)fIntegralRange.X();
+        parameters.fIntegralEnd = (Int_t)fIntegralRange.Y();
+        parameters.fPointThreshold = fPointThreshold;
+        parameters.fSignalThreshold = fSignalThreshold;
+        parameters.fNPointsOverThreshold = fNPointsOverThreshold;
+        parameters.fNPointsFlatThreshold = fNPointsFlatThreshold;
+        return parameters;
+    }
+
     /// It prints out the process parameters stored in the metadata structure
     void PrintMetadata() override {
         BeginPrintProcess();
@@ -71,15 +122,9 @@ class TRestRawZeroSuppresionProcess : public TRestLegacyProcess {
         EndPrintProcess();
     }
 
-    TRestRawZeroSuppresionProcess() {
-        RESTWarning << "Creating legacy process TRestRawZeroSuppresionProcess" << RESTendl;
-        RESTWarning << "This process is now implemented under TRestRawToDetectorSignalProcess" << RESTendl;
-    }
+    TRestRawZeroSuppresionProcess() { CountInstance("TRestRawZeroSuppresionProcess"); }
 
-    TRestRawZeroSuppresionProcess(char* cfgFileName) {
-        RESTWarning << "Creating legacy process TRestRawZeroSuppresionProcess" << RESTendl;
-        RESTWarning << "This process is now implemented under TRestRawToDetectorSignalProcess" << RESTendl;
-    }
+    TRestRawZeroSuppresionProcess(char* cfgFileName) { CountInstance("TRestRawZeroSuppresionProcess"); }
 
     ClassDefOverride(TRestRawZeroSuppresionProcess, 4);
 };
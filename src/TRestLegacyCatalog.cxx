@@ -0,0 +1,443 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyCatalog builds and queries an index of the legacy process
+/// objects (TRestRawZeroSuppresionProcess and
+/// TRestRawSignalRecoverChannelsProcess) stored in a list of run files.
+/// It allows to answer questions such as which runs used a given baseline
+/// range, or recovered a given channel, without opening the run files.
+///
+/// Update scans the run files in parallel and writes the index to a
+/// sidecar file. The index file is then memory-mapped, so that queries
+/// only touch the pages they need. Each indexed file keeps its size and
+/// modification time, and files which did not change since the previous
+/// Update are not scanned again. Legacy objects are decoded using
+/// TRestLegacyStreamer, so that they are not created while scanning.
+///
+/// \code
+///     TRestLegacyCatalog catalog;
+///     catalog.Update(runFiles, "legacy.idx");
+///     for (const auto& run : catalog.FindByBaseLineRange(5, 55)) cout << run << endl;
+///     for (const auto& run : catalog.FindByRecoveredChannel(67)) cout << run << endl;
+/// \endcode
+///
+/// The index file contains a header followed by four contiguous arrays:
+/// the indexed files, the legacy object records, the recovered channel
+/// ids and a pool with all the strings. The layout is native endian, and
+/// it is meant to be used on the machine that created it.
+///
+/// The `restLegacyCatalog` tool, compiled with `-DREST_LEGACY_TOOLS=ON`,
+/// gives access to this class from the command line.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyCatalog.
+///
+/// \class      TRestLegacyCatalog
+///
+/// <hr>
+///
+
+#include "TRestLegacyCatalog.h"
+
+#include <TFile.h>
+#include <TKey.h>
+#include <TROOT.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <thread>
+
+#include "TRestLegacyStreamer.h"
+#include "TRestRawSignalRecoverChannelsProcess.h"
+#include "TRestRawZeroSuppresionProcess.h"
+
+namespace {
+
+const char kIndexMagic[8] = {'R', 'L', 'E', 'G', 'C', 'A', 'T', '\0'};
+const UInt_t kIndexVersion = 1;
+
+struct IndexHeader {
+    char fMagic[8];
+    UInt_t fVersion;
+    Int_t fNFiles;
+    Int_t fNRecords;
+    Int_t fNChannels;
+    UInt_t fStringsSize;
+    UInt_t fPadding;
+};
+
+/// The contents of an index being built. Offsets are relative to its own pools.
+struct IndexContents {
+    std::vector<TRestLegacyCatalog::FileEntry> fFiles;
+    std::vector<TRestLegacyCatalog::Record> fRecords;
+    std::vector<Int_t> fChannels;
+    std::string fStrings;
+
+    UInt_t AddString(const std::string& str) {
+        UInt_t offset = fStrings.size();
+        fStrings += str;
+        return offset;
+    }
+
+    /// It appends the records and channels of a single file, moving them to this index pools
+    void AddFile(const std::string& path, Long64_t size, Long64_t modificationTime,
+                 const std::vector<TRestLegacyCatalog::Record>& records, const std::vector<Int_t>& channels,
+                 const std::string& strings) {
+        TRestLegacyCatalog::FileEntry entry;
+        entry.fPathOffset = AddString(path);
+        entry.fPathLength = path.size();
+        entry.fSize = size;
+        entry.fModificationTime = modificationTime;
+        entry.fFirstRecord = fRecords.size();
+        entry.fNRecords = records.size();
+
+        UInt_t stringsOffset = AddString(strings);
+        Int_t channelsOffset = fChannels.size();
+        fChannels.insert(fChannels.end(), channels.begin(), channels.end());
+        for (auto record : records) {
+            record.fFile = fFiles.size();
+            record.fNameOffset += stringsOffset;
+            record.fChannelOffset += channelsOffset;
+            fRecords.push_back(record);
+        }
+        fFiles.push_back(entry);
+    }
+};
+
+/// The legacy objects found in a single run file. Offsets are relative to its own pools.
+struct FileScan {
+    std::string fPath;
+    Long64_t fSize = 0;
+    Long64_t fModificationTime = 0;
+    bool fScanned = false;
+    std::vector<TRestLegacyCatalog::Record> fRecords;
+    std::vector<Int_t> fChannels;
+    std::string fStrings;
+};
+
+bool GetFileStatus(const std::string& path, Long64_t& size, Long64_t& modificationTime) {
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0) return false;
+    size = status.st_size;
+    modificationTime = status.st_mtime;
+    return true;
+}
+
+TRestLegacyCatalog::Record CreateRecord(FileScan& scan, const std::string& name, Int_t legacyClass) {
+    TRestLegacyCatalog::Record record;
+    memset(&record, 0, sizeof(record));
+    record.fClass = legacyClass;
+    record.fNameOffset = scan.fStrings.size();
+    record.fNameLength = name.size();
+    record.fChannelOffset = scan.fChannels.size();
+    scan.fStrings += name;
+    return record;
+}
+
+void ScanFile(FileScan& scan, TRestLegacyStreamer& streamer) {
+    TFile* file = TFile::Open(scan.fPath.c_str(), "READ");
+    if (file == nullptr || file->IsZombie()) {
+        delete file;
+        return;
+    }
+
+    std::set<std::string> names;
+    std::chrono::steady_clock::duration streamingTime(0);
+    TIter next(file->GetListOfKeys());
+    while (TKey* key = (TKey*)next()) {
+        std::string className = key->GetClassName();
+        if (className != "TRestRawZeroSuppresionProcess" &&
+            className != "TRestRawSignalRecoverChannelsProcess")
+            continue;
+        // Keys are sorted by decreasing cycle, only the last cycle is indexed
+        if (!names.insert(key->GetName()).second) continue;
+
+        auto start = std::chrono::steady_clock::now();
+
+        // Fast path, decoding the object without creating it
+        TRestLegacyCatalog::Record record = CreateRecord(scan, key->GetName(), 0);
+        if (streamer.Decode(file, key, record, scan.fChannels)) {
+            scan.fRecords.push_back(record);
+            streamingTime += std::chrono::steady_clock::now() - start;
+            continue;
+        }
+
+        TObject* obj = key->ReadObj();
+        if (auto zs = dynamic_cast<TRestRawZeroSuppresionProcess*>(obj)) {
+            record.fClass = TRestLegacyCatalog::kZeroSuppression;
+            record.fBaseLineRange[0] = zs->GetBaseLineRange().X();
+            record.fBaseLineRange[1] = zs->GetBaseLineRange().Y();
+            record.fIntegralRange[0] = zs->GetIntegralRange().X();
+            record.fIntegralRange[1] = zs->GetIntegralRange().Y();
+            record.fPointThreshold = zs->GetPointThreshold();
+            record.fSignalThreshold = zs->GetSignalThreshold();
+            record.fSampling = zs->GetSampling();
+            record.fNPointsOverThreshold = zs->GetNPointsOverThreshold();
+            record.fNPointsFlatThreshold = zs->GetNPointsFlatThreshold();
+            record.fBaseLineCorrection = zs->GetBaseLineCorrection();
+            scan.fRecords.push_back(record);
+        } else if (auto recover = dynamic_cast<TRestRawSignalRecoverChannelsProcess*>(obj)) {
+            record.fClass = TRestLegacyCatalog::kRecoverChannels;
+            const auto& channelIds = recover->GetChannelIds();
+            record.fNChannels = channelIds.size();
+            scan.fChannels.insert(scan.fChannels.end(), channelIds.begin(), channelIds.end());
+            scan.fRecords.push_back(record);
+        }
+        delete obj;
+        streamingTime += std::chrono::steady_clock::now() - start;
+    }
+
+    if (!names.empty()) {
+        TRestLegacyProcess::AddReaderFile();
+        TRestLegacyProcess::AddReaderStreamingTime(std::chrono::duration<Double_t>(streamingTime).count());
+    }
+
+    scan.fScanned = true;
+    delete file;
+}
+
+bool WriteIndex(const IndexContents& contents, const std::string& indexFile) {
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.fMagic, kIndexMagic, sizeof(kIndexMagic));
+    header.fVersion = kIndexVersion;
+    header.fNFiles = contents.fFiles.size();
+    header.fNRecords = contents.fRecords.size();
+    header.fNChannels = contents.fChannels.size();
+    header.fStringsSize = contents.fStrings.size();
+
+    // The index is written to a temporary file and renamed, so that readers never see a partial index
+    std::string temporaryFile = indexFile + ".tmp";
+    FILE* out = fopen(temporaryFile.c_str(), "wb");
+    if (out == nullptr) return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    ok &= fwrite(contents.fFiles.data(), sizeof(TRestLegacyCatalog::FileEntry), contents.fFiles.size(),
+                 out) == contents.fFiles.size();
+    ok &= fwrite(contents.fRecords.data(), sizeof(TRestLegacyCatalog::Record), contents.fRecords.size(),
+                 out) == contents.fRecords.size();
+    ok &= fwrite(contents.fChannels.data(), sizeof(Int_t), contents.fChannels.size(), out) ==
+          contents.fChannels.size();
+    ok &= fwrite(contents.fStrings.data(), 1, contents.fStrings.size(), out) == contents.fStrings.size();
+    ok &= fclose(out) == 0;
+
+    if (!ok || rename(temporaryFile.c_str(), indexFile.c_str()) != 0) {
+        remove(temporaryFile.c_str());
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+void TRestLegacyCatalog::Unmap() {
+    if (fMappedData != nullptr) munmap(fMappedData, fMappedSize);
+    fMappedData = nullptr;
+    fMappedSize = 0;
+    fFiles = nullptr;
+    fRecords = nullptr;
+    fChannels = nullptr;
+    fStrings = nullptr;
+    fNFiles = 0;
+    fNRecords = 0;
+}
+
+///////////////////////////////////////////////
+/// \brief It maps an existing index file. It returns false if the file is missing or not valid.
+///
+bool TRestLegacyCatalog::Open(const std::string& indexFile) {
+    Unmap();
+
+    int fd = open(indexFile.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(IndexHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    fMappedData = data;
+    fMappedSize = status.st_size;
+
+    const IndexHeader* header = static_cast<const IndexHeader*>(fMappedData);
+    size_t expectedSize = sizeof(IndexHeader) + (size_t)header->fNFiles * sizeof(FileEntry) +
+                          (size_t)header->fNRecords * sizeof(Record) +
+                          (size_t)header->fNChannels * sizeof(Int_t) + header->fStringsSize;
+    if (memcmp(header->fMagic, kIndexMagic, sizeof(kIndexMagic)) != 0 || header->fVersion != kIndexVersion ||
+        expectedSize != fMappedSize) {
+        Unmap();
+        return false;
+    }
+
+    const char* position = static_cast<const char*>(fMappedData) + sizeof(IndexHeader);
+    fFiles = reinterpret_cast<const FileEntry*>(position);
+    position += header->fNFiles * sizeof(FileEntry);
+    fRecords = reinterpret_cast<const Record*>(position);
+    position += header->fNRecords * sizeof(Record);
+    fChannels = reinterpret_cast<const Int_t*>(position);
+    position += header->fNChannels * sizeof(Int_t);
+    fStrings = position;
+
+    fNFiles = header->fNFiles;
+    fNRecords = header->fNRecords;
+    fIndexFile = indexFile;
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It indexes the given run files, writes the index to `indexFile` and maps it.
+///
+/// If `indexFile` already exists, the files whose size and modification time did not change
+/// are taken from it without being opened. The remaining files are scanned using `nThreads`
+/// threads, or as many threads as hardware cores if `nThreads` is 0. Files that cannot be
+/// opened are not indexed.
+///
+bool TRestLegacyCatalog::Update(const std::vector<std::string>& runFiles, const std::string& indexFile,
+                                Int_t nThreads) {
+    std::map<std::string, Int_t> previousFiles;
+    if (Open(indexFile))
+        for (Int_t n = 0; n < fNFiles; n++) previousFiles[GetFilePath(n)] = n;
+
+    std::vector<FileScan> scans(runFiles.size());
+    std::vector<size_t> pending;
+    for (size_t n = 0; n < runFiles.size(); n++) {
+        FileScan& scan = scans[n];
+        scan.fPath = runFiles[n];
+        if (!GetFileStatus(scan.fPath, scan.fSize, scan.fModificationTime)) continue;
+
+        auto previous = previousFiles.find(scan.fPath);
+        if (previous != previousFiles.end()) {
+            const FileEntry& entry = fFiles[previous->second];
+            if (entry.fSize == scan.fSize && entry.fModificationTime == scan.fModificationTime) {
+                for (Int_t r = entry.fFirstRecord; r < entry.fFirstRecord + entry.fNRecords; r++) {
+                    Record record = fRecords[r];
+                    record.fNameOffset = scan.fStrings.size();
+                    record.fChannelOffset = scan.fChannels.size();
+                    scan.fStrings += GetRecordName(fRecords[r]);
+                    std::vector<Int_t> channels = GetRecordChannels(fRecords[r]);
+                    scan.fChannels.insert(scan.fChannels.end(), channels.begin(), channels.end());
+                    scan.fRecords.push_back(record);
+                }
+                scan.fScanned = true;
+                continue;
+            }
+        }
+        pending.push_back(n);
+    }
+
+    if (nThreads <= 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+    nThreads = std::min<Int_t>(nThreads, pending.size());
+    if (nThreads > 1) ROOT::EnableThreadSafety();
+
+    std::atomic<size_t> nextPending(0);
+    auto worker = [&]() {
+        TRestLegacyStreamer streamer;
+        for (size_t n = nextPending++; n < pending.size(); n = nextPending++)
+            ScanFile(scans[pending[n]], streamer);
+    };
+    std::vector<std::thread> threads;
+    for (Int_t n = 1; n < nThreads; n++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+
+    IndexContents contents;
+    for (const auto& scan : scans)
+        if (scan.fScanned)
+            contents.AddFile(scan.fPath, scan.fSize, scan.fModificationTime, scan.fRecords, scan.fChannels,
+                             scan.fStrings);
+
+    Unmap();
+    if (!WriteIndex(contents, indexFile)) return false;
+    return Open(indexFile);
+}
+
+std::string TRestLegacyCatalog::GetFilePath(Int_t n) const {
+    return std::string(fStrings + fFiles[n].fPathOffset, fFiles[n].fPathLength);
+}
+
+std::string TRestLegacyCatalog::GetRecordName(const Record& record) const {
+    return std::string(fStrings + record.fNameOffset, record.fNameLength);
+}
+
+std::vector<Int_t> TRestLegacyCatalog::GetRecordChannels(const Record& record) const {
+    return std::vector<Int_t>(fChannels + record.fChannelOffset,
+                              fChannels + record.fChannelOffset + record.fNChannels);
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the files containing at least one legacy object fulfilling the selection
+///
+std::vector<std::string> TRestLegacyCatalog::FindFiles(
+    const std::function<bool(const Record&)>& selection) const {
+    std::vector<std::string> result;
+    for (Int_t n = 0; n < fNFiles; n++) {
+        const FileEntry& entry = fFiles[n];
+        for (Int_t r = entry.fFirstRecord; r < entry.fFirstRecord + entry.fNRecords; r++) {
+            if (selection(fRecords[r])) {
+                result.push_back(GetFilePath(n));
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> TRestLegacyCatalog::FindByBaseLineRange(Double_t start, Double_t end) const {
+    return FindFiles([start, end](const Record& record) {
+        return record.fClass == kZeroSuppression && record.fBaseLineRange[0] == start &&
+               record.fBaseLineRange[1] == end;
+    });
+}
+
+std::vector<std::string> TRestLegacyCatalog::FindByIntegralRange(Double_t start, Double_t end) const {
+    return FindFiles([start, end](const Record& record) {
+        return record.fClass == kZeroSuppression && record.fIntegralRange[0] == start &&
+               record.fIntegralRange[1] == end;
+    });
+}
+
+std::vector<std::string> TRestLegacyCatalog::FindByRecoveredChannel(Int_t channelId) const {
+    return FindFiles([this, channelId](const Record& record) {
+        if (record.fClass != kRecoverChannels) return false;
+        const Int_t* first = fChannels + record.fChannelOffset;
+        return std::find(first, first + record.fNChannels, channelId) != first + record.fNChannels;
+    });
+}
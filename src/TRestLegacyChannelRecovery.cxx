@@ -0,0 +1,217 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyChannelRecovery implements the dead channel recovery
+/// algorithm described at TRestRawSignalRecoverChannelsProcess as a sparse
+/// interpolation table. Each target (dead) channel is recovered as the
+/// weighted sum of any number of neighbour channels,
+/// \f$s_i = \sum_j w_j s_j\f$. The legacy rule,
+/// \f$s_i = 0.5 \times (s_{i-1} + s_{i+1})\f$, corresponds to two neighbours
+/// with the default weights. If no weights are given, each neighbour
+/// receives the same weight, 1/N.
+///
+/// The table is defined in terms of signal ids, typically once at
+/// initialization using the readout to find the adjacent signal ids
+/// (see TRestRawSignalRecoverChannelsProcess::GetChannelRecovery). Then,
+/// Compile translates the signal ids into rows of a batch of signals, so
+/// that no readout lookup or map search is required while processing
+/// events.
+///
+/// The batch stores the signals of several events in a structure of
+/// arrays layout: the samples of a given channel are contiguous for all
+/// the events in the batch, as given by GetBatchIndex,
+/// `batch[(row * nEvents + event) * nBins + bin]`.
+/// Therefore, recovering a channel is a weighted sum of contiguous arrays
+/// of `nEvents * nBins` samples, which is vectorized by the compiler.
+///
+/// Targets are recovered in the order they were added, and in-place, as
+/// the legacy process did. Therefore, a target may use as neighbour a
+/// previously recovered target. Neighbours missing from the batch
+/// contribute with zero, and targets missing from the batch are skipped.
+///
+/// ApplyParallel gives the same result as Apply, using the threads of a
+/// TRestLegacyTaskPool. Compile groups the targets in waves: a target is
+/// placed in the wave following the last previous target it depends on,
+/// i.e. a previous target using its row as neighbour, writing one of its
+/// neighbour rows, or writing its own row. The targets of a wave are
+/// independent, and each of them is split in chunks of samples, so that a
+/// single dead channel in a large batch is also shared among the threads.
+/// Waves are executed one after the other. Each sample is computed with
+/// the same operations as in Apply, so the results are identical.
+///
+/// \code
+///     TRestLegacyChannelRecovery recovery;
+///     recovery.AddTarget(17, {16, 18});               // Legacy rule
+///     recovery.AddTarget(67, {66, 68, 35}, {0.4, 0.4, 0.2});
+///     recovery.Compile(rowSignalIds);
+///
+///     // For each batch of events
+///     recovery.Apply(batch.data(), nEvents, nBins);
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyChannelRecovery.
+///
+/// 2026-October: Independent targets recovered in parallel.
+///
+/// \class      TRestLegacyChannelRecovery
+///
+/// <hr>
+///
+
+#include "TRestLegacyChannelRecovery.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "TRestLegacyTaskPool.h"
+
+///////////////////////////////////////////////
+/// \brief It adds a channel to be recovered from the given neighbour channels
+///
+/// If no weights are given, or their number does not match the number of neighbours,
+/// all the neighbours receive the same weight. A target is never used as its own neighbour.
+///
+void TRestLegacyChannelRecovery::AddTarget(Int_t targetId, const std::vector<Int_t>& neighbourIds,
+                                           const std::vector<Float_t>& weights) {
+    bool useWeights = weights.size() == neighbourIds.size();
+
+    Int_t nNeighbours = std::count_if(neighbourIds.begin(), neighbourIds.end(),
+                                      [targetId](Int_t id) { return id != targetId; });
+
+    for (size_t n = 0; n < neighbourIds.size(); n++) {
+        if (neighbourIds[n] == targetId) continue;
+        fNeighbourIds.push_back(neighbourIds[n]);
+        fNeighbourWeights.push_back(useWeights ? weights[n] : 1.f / nNeighbours);
+    }
+
+    fTargetIds.push_back(targetId);
+    fNeighbourOffsets.push_back(fNeighbourIds.size());
+}
+
+///////////////////////////////////////////////
+/// \brief It translates the signal ids of the table into rows of the batch
+///
+/// `rowSignalIds` contains the signal id stored at each row of the batches that will be given to
+/// Apply. It must be called again if the rows of the batch change.
+///
+void TRestLegacyChannelRecovery::Compile(const std::vector<Int_t>& rowSignalIds) {
+    std::unordered_map<Int_t, Int_t> rows;
+    for (size_t row = 0; row < rowSignalIds.size(); row++) rows.emplace(rowSignalIds[row], row);
+
+    auto getRow = [&rows](Int_t id) {
+        auto it = rows.find(id);
+        return it == rows.end() ? -1 : it->second;
+    };
+
+    fTargetRows.resize(fTargetIds.size());
+    std::transform(fTargetIds.begin(), fTargetIds.end(), fTargetRows.begin(), getRow);
+
+    fNeighbourRows.resize(fNeighbourIds.size());
+    std::transform(fNeighbourIds.begin(), fNeighbourIds.end(), fNeighbourRows.begin(), getRow);
+
+    // The last wave writing each row, and the last wave reading it
+    std::vector<Int_t> lastWrite(rowSignalIds.size(), -1);
+    std::vector<Int_t> lastRead(rowSignalIds.size(), -1);
+    fWaves.clear();
+    for (size_t n = 0; n < fTargetIds.size(); n++) {
+        Int_t row = fTargetRows[n];
+        if (row < 0) continue;
+
+        Int_t wave = std::max(lastWrite[row], lastRead[row]) + 1;
+        for (Int_t m = fNeighbourOffsets[n]; m < fNeighbourOffsets[n + 1]; m++)
+            if (fNeighbourRows[m] >= 0) wave = std::max(wave, lastWrite[fNeighbourRows[m]] + 1);
+
+        lastWrite[row] = wave;
+        for (Int_t m = fNeighbourOffsets[n]; m < fNeighbourOffsets[n + 1]; m++) {
+            Int_t neighbourRow = fNeighbourRows[m];
+            if (neighbourRow >= 0) lastRead[neighbourRow] = std::max(lastRead[neighbourRow], wave);
+        }
+
+        if (wave == (Int_t)fWaves.size()) fWaves.emplace_back();
+        fWaves[wave].push_back(n);
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It recovers target `n` in all the events of the batch
+///
+void TRestLegacyChannelRecovery::ApplyTarget(size_t n, Float_t* batch, Int_t nEvents, Int_t nBins) const {
+    const size_t length = (size_t)nEvents * nBins;
+    ApplyTarget(n, batch, length, 0, length);
+}
+
+///////////////////////////////////////////////
+/// \brief It recovers the samples [from, to) of target `n`, whose rows have `length` samples
+///
+void TRestLegacyChannelRecovery::ApplyTarget(size_t n, Float_t* batch, size_t length, size_t from,
+                                             size_t to) const {
+    if (fTargetRows[n] < 0) return;
+
+    Float_t* __restrict target = batch + fTargetRows[n] * length;
+    std::fill(target + from, target + to, 0.f);
+
+    for (Int_t m = fNeighbourOffsets[n]; m < fNeighbourOffsets[n + 1]; m++) {
+        if (fNeighbourRows[m] < 0) continue;
+        const Float_t* __restrict neighbour = batch + fNeighbourRows[m] * length;
+        const Float_t weight = fNeighbourWeights[m];
+        for (size_t k = from; k < to; k++) target[k] += weight * neighbour[k];
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It recovers all the targets in all the events of the batch
+///
+/// Compile must have been called before.
+///
+void TRestLegacyChannelRecovery::Apply(Float_t* batch, Int_t nEvents, Int_t nBins) const {
+    for (size_t n = 0; n < fTargetIds.size(); n++) ApplyTarget(n, batch, nEvents, nBins);
+}
+
+///////////////////////////////////////////////
+/// \brief It recovers all the targets in all the events of the batch, in parallel
+///
+/// The result is the same as given by Apply. If no pool is given, the pool shared by the
+/// application is used. Compile must have been called before.
+///
+void TRestLegacyChannelRecovery::ApplyParallel(Float_t* batch, Int_t nEvents, Int_t nBins,
+                                               TRestLegacyTaskPool* pool) const {
+    if (pool == nullptr) pool = &TRestLegacyTaskPool::Instance();
+
+    // Chunks of samples large enough to amortize the cost of scheduling a task
+    const size_t length = (size_t)nEvents * nBins;
+    const size_t chunk = 16384;
+    const size_t nChunks = (length + chunk - 1) / chunk;
+
+    for (const auto& wave : fWaves) {
+        pool->ParallelFor(wave.size() * nChunks, [&](size_t task) {
+            size_t from = (task % nChunks) * chunk;
+            ApplyTarget(wave[task / nChunks], batch, length, from, std::min(length, from + chunk));
+        });
+    }
+}
@@ -0,0 +1,364 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyMigration rewrites a list of run files so that they do not
+/// contain legacy process objects anymore. Migrated files can be read
+/// without the legacy library.
+///
+/// Every object of the input file is copied to the output file, keeping
+/// the directory structure, except the legacy processes (any class
+/// inheriting from TRestLegacyProcess). Those are replaced by an instance
+/// of their successor process, with the legacy parameters translated as
+/// described in TRestLegacyProcess, and written with the same name.
+///
+/// Trees are copied by fast cloning, i.e. their baskets are copied without
+/// being decompressed. If new compression settings are given through
+/// SetCompression, the trees are decompressed and written again with the
+/// new settings, e.g. to move old archives to ZSTD.
+///
+/// \code
+///     TRestLegacyMigration migration;
+///     migration.SetCompression(ROOT::CompressionSettings(ROOT::RCompressionSetting::EAlgorithm::kZSTD, 5));
+///     migration.SetMaxMemory(4000000000);
+///     for (const auto& result : migration.Migrate(runFiles, "migrated/"))
+///         if (!result.fSuccess) cout << result.fInput << " : " << result.fMessage << endl;
+/// \endcode
+///
+/// Migrate spreads the files among the threads of a TRestLegacyTaskPool,
+/// starting by the largest files. The memory needed by each file, its
+/// largest tree and one cluster of it, is estimated from the key headers
+/// before any tree is read. If SetMaxMemory was given, a file waits until
+/// the files already being copied leave enough memory for it. A file that
+/// needs more memory than the limit is copied alone.
+///
+/// Output files are written to a temporary file which is renamed when the
+/// migration succeeds, so that a failed migration leaves no output file.
+/// A file fails if one of its legacy objects cannot be translated, i.e. if
+/// the library defining its successor is not available.
+///
+/// The `restLegacyMigrate` tool, compiled with `-DREST_LEGACY_TOOLS=ON`,
+/// gives access to this class from the command line.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyMigration.
+///
+/// \class      TRestLegacyMigration
+///
+/// <hr>
+///
+
+#include "TRestLegacyMigration.h"
+
+#include <TClass.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include "TRestLegacyProcess.h"
+#include "TRestLegacyTaskPool.h"
+
+/// The memory shared by the files being migrated at the same time
+struct TRestLegacyMigration::MemoryBudget {
+    std::mutex fMutex;
+    std::condition_variable fReleased;
+    Long64_t fLimit = 0;
+    Long64_t fInUse = 0;
+
+    /// It waits until `bytes` are available. If nothing is in use, it never waits.
+    void Acquire(Long64_t bytes) {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fReleased.wait(lock, [&]() { return fInUse == 0 || fInUse + bytes <= fLimit; });
+        fInUse += bytes;
+    }
+
+    void Release(Long64_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fInUse -= bytes;
+        }
+        fReleased.notify_all();
+    }
+};
+
+namespace {
+
+/// It returns the keys of a directory, keeping only the highest cycle of each name
+std::vector<TKey*> GetLatestKeys(TDirectory* directory) {
+    std::vector<TKey*> keys;
+    std::set<std::string> names;
+    TIter next(directory->GetListOfKeys());
+    while (TKey* key = (TKey*)next())
+        if (names.insert(key->GetName()).second) keys.push_back(key);
+    return keys;
+}
+
+bool InheritsFrom(TKey* key, const TClass* base) {
+    TClass* cl = TClass::GetClass(key->GetClassName());
+    return cl != nullptr && cl->InheritsFrom(base);
+}
+
+/// ROOT's default cluster size, in compressed bytes (see TTree::SetAutoFlush)
+const Long64_t kDefaultClusterBytes = 30000000;
+
+/// It returns the uncompressed size of the largest tree object in a directory and its
+/// subdirectories, as given by the key headers
+Long64_t GetLargestTreeSize(TDirectory* directory) {
+    Long64_t bytes = 0;
+    for (TKey* key : GetLatestKeys(directory)) {
+        if (InheritsFrom(key, TDirectory::Class())) {
+            TDirectory* subdirectory = directory->GetDirectory(key->GetName());
+            if (subdirectory != nullptr) bytes = std::max(bytes, GetLargestTreeSize(subdirectory));
+        } else if (InheritsFrom(key, TTree::Class())) {
+            bytes = std::max<Long64_t>(bytes, key->GetObjlen());
+        }
+    }
+    return bytes;
+}
+
+Long64_t GetFileSize(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) return 0;
+    fseek(file, 0, SEEK_END);
+    Long64_t size = ftell(file);
+    fclose(file);
+    return size;
+}
+}  // namespace
+
+///////////////////////////////////////////////
+/// \brief It estimates the memory needed to copy the trees of a directory, without reading them
+///
+/// The estimation is twice the in-memory size of the largest tree object, for the input tree and
+/// its copy, plus one cluster of data. Since the cluster size is only known once the tree is read,
+/// ROOT's default cluster size (30 MB of compressed data) is assumed, bounded by the file size.
+/// When the trees are recompressed, the cluster is counted uncompressed, using the compression
+/// factor of the file.
+///
+Long64_t TRestLegacyMigration::EstimateMemory(TDirectory* input, bool recompress) {
+    Long64_t treeBytes = GetLargestTreeSize(input);
+    TFile* file = input->GetFile();
+    if (treeBytes == 0 || file == nullptr) return treeBytes;
+
+    Double_t cluster = std::min<Long64_t>(file->GetSize(), kDefaultClusterBytes);
+    if (recompress) cluster *= std::max<Double_t>(file->GetCompressionFactor(), 1);
+    return 2 * treeBytes + (Long64_t)cluster;
+}
+
+bool TRestLegacyMigration::CopyDirectory(TDirectory* input, TDirectory* output, Result& result) const {
+    for (TKey* key : GetLatestKeys(input)) {
+        if (InheritsFrom(key, TDirectory::Class())) {
+            TDirectory* inputDirectory = input->GetDirectory(key->GetName());
+            if (inputDirectory == nullptr) {
+                result.fMessage = std::string("Cannot read directory ") + key->GetName();
+                return false;
+            }
+            TDirectory* outputDirectory = output->mkdir(key->GetName(), inputDirectory->GetTitle());
+            if (outputDirectory == nullptr) {
+                result.fMessage = std::string("Cannot create directory ") + key->GetName();
+                return false;
+            }
+            if (!CopyDirectory(inputDirectory, outputDirectory, result)) return false;
+            continue;
+        }
+
+        if (InheritsFrom(key, TTree::Class())) {
+            std::unique_ptr<TTree> tree((TTree*)key->ReadObj());
+            output->cd();
+            TTree* clone = nullptr;
+            if (fCompression < 0) {
+                clone = tree->CloneTree(-1, "fast");
+            } else {
+                clone = tree->CloneTree(0);
+                TIter next(clone->GetListOfBranches());
+                while (TBranch* branch = (TBranch*)next()) branch->SetCompressionSettings(fCompression);
+                clone->CopyEntries(tree.get());
+            }
+            if (clone == nullptr) {
+                result.fMessage = std::string("Cannot copy tree ") + key->GetName();
+                return false;
+            }
+            clone->Write(key->GetName());
+            delete clone;
+            result.fNTrees++;
+            continue;
+        }
+
+        TClass* cl = TClass::GetClass(key->GetClassName());
+        if (cl != nullptr && !cl->IsTObject()) {
+            // Objects not inheriting from TObject are copied through their dictionary
+            void* object = key->ReadObjectAny(cl);
+            if (object == nullptr) {
+                result.fMessage = std::string("Cannot read ") + key->GetName();
+                return false;
+            }
+            output->WriteObjectAny(object, cl, key->GetName());
+            cl->Destructor(object);
+            result.fNObjects++;
+            continue;
+        }
+
+        std::unique_ptr<TObject> obj(key->ReadObj());
+        if (obj == nullptr) {
+            result.fMessage = std::string("Cannot read ") + key->GetName();
+            return false;
+        }
+
+        TObject* written = obj.get();
+        if (auto legacy = dynamic_cast<TRestLegacyProcess*>(obj.get())) {
+            // The successor is owned, and deleted, by the legacy object
+            written = legacy->GetSuccessor();
+            if (written == nullptr) {
+                result.fMessage = std::string("Cannot translate ") + key->GetName() + " (" +
+                                  key->GetClassName() + "), successor " +
+                                  TRestLegacyProcess::GetSuccessorName(key->GetClassName()) +
+                                  " not available";
+                return false;
+            }
+            result.fNTranslated++;
+        } else {
+            result.fNObjects++;
+        }
+
+        output->cd();
+        written->Write(key->GetName());
+    }
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It migrates the run file `input`, writing the result to `output`
+///
+TRestLegacyMigration::Result TRestLegacyMigration::MigrateFile(const std::string& input,
+                                                               const std::string& output) const {
+    return MigrateFile(input, output, nullptr);
+}
+
+TRestLegacyMigration::Result TRestLegacyMigration::MigrateFile(const std::string& input,
+                                                               const std::string& output,
+                                                               MemoryBudget* budget) const {
+    auto start = std::chrono::steady_clock::now();
+
+    Result result;
+    result.fInput = input;
+    result.fOutput = output;
+    result.fInputBytes = GetFileSize(input);
+
+    if (input == output) {
+        result.fMessage = "Output file is the input file";
+        return result;
+    }
+
+    std::unique_ptr<TFile> inputFile(TFile::Open(input.c_str(), "READ"));
+    if (inputFile == nullptr || inputFile->IsZombie()) {
+        result.fMessage = "Cannot open input file";
+        return result;
+    }
+
+    Long64_t memory = 0;
+    if (budget != nullptr) {
+        memory = EstimateMemory(inputFile.get(), fCompression >= 0);
+        budget->Acquire(memory);
+    }
+
+    std::string temporary = output + ".tmp";
+    Int_t compression = fCompression < 0 ? inputFile->GetCompressionSettings() : fCompression;
+    std::unique_ptr<TFile> outputFile(TFile::Open(temporary.c_str(), "RECREATE", "", compression));
+    if (outputFile == nullptr || outputFile->IsZombie()) {
+        result.fMessage = "Cannot create output file";
+    } else {
+        result.fSuccess = CopyDirectory(inputFile.get(), outputFile.get(), result);
+        outputFile->Close();
+    }
+    outputFile.reset();
+    inputFile.reset();
+
+    if (budget != nullptr) budget->Release(memory);
+
+    if (result.fSuccess && rename(temporary.c_str(), output.c_str()) != 0) {
+        result.fSuccess = false;
+        result.fMessage = "Cannot rename " + temporary;
+    }
+    if (!result.fSuccess) remove(temporary.c_str());
+
+    result.fOutputBytes = result.fSuccess ? GetFileSize(output) : 0;
+    result.fTime = std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+///////////////////////////////////////////////
+/// \brief It migrates the given run files in parallel, writing them to `outputDir` with the same file name
+///
+/// The results are given in the same order as `inputs`.
+///
+std::vector<TRestLegacyMigration::Result> TRestLegacyMigration::Migrate(
+    const std::vector<std::string>& inputs, const std::string& outputDir) const {
+    std::vector<Result> results(inputs.size());
+
+    // The largest files are started first, so that they do not remain alone at the end
+    std::vector<std::pair<Long64_t, size_t>> order;
+    for (size_t n = 0; n < inputs.size(); n++) order.emplace_back(GetFileSize(inputs[n]), n);
+    std::sort(order.begin(), order.end(), std::greater<>());
+
+    MemoryBudget budget;
+    budget.fLimit = fMaxMemory;
+
+    // Each task takes the largest file not started yet, whichever the order in which tasks are run
+    std::atomic<size_t> next(0);
+    auto migrate = [&](size_t) {
+        size_t n = order[next++].second;
+        std::string output = outputDir;
+        if (!output.empty() && output.back() != '/') output += "/";
+        output += inputs[n].substr(inputs[n].find_last_of('/') + 1);
+        results[n] = MigrateFile(inputs[n], output, fMaxMemory > 0 ? &budget : nullptr);
+    };
+
+    Int_t nThreads = fNThreads > 0 ? fNThreads : TRestLegacyTaskPool::Instance().GetNumberOfThreads() + 1;
+    nThreads = std::min<Int_t>(nThreads, inputs.size());
+    if (nThreads <= 1) {
+        for (size_t n = 0; n < inputs.size(); n++) migrate(n);
+        return results;
+    }
+
+    ROOT::EnableThreadSafety();
+    // The calling thread also migrates files, so the pool needs one thread less
+    TRestLegacyTaskPool pool(nThreads - 1);
+    pool.ParallelFor(inputs.size(), migrate);
+    return results;
+}
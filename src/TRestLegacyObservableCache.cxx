@@ -0,0 +1,404 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyObservableCache keeps the event observables of the legacy
+/// zero suppression, recomputed from the raw data with the parameters
+/// stored in a TRestRawZeroSuppresionProcess, in a persistent cache file.
+/// Later analyses read the observables from the cache instead of
+/// processing the event tree again.
+///
+/// The observables of each event are:
+/// * NumberOfSignals : number of signals with at least one point
+/// surviving the zero suppression.
+/// * NumberOfPoints : total number of surviving points.
+/// * BaseLineMean : average over all the signals of the baseline mean.
+/// * BaseLineSigmaMean : average over all the signals of the baseline
+/// sigma.
+/// * Integral : sum of the surviving points, with the baseline of their
+/// signal subtracted.
+///
+/// Each event is identified by its run id, its event id and a hash of the
+/// zero suppression parameters (see GetParameterHash), so that a single
+/// cache file may keep the observables of several parameter sets.
+///
+/// \code
+///     TRestLegacyZeroSuppression::Parameters parameters = zsProcess->GetZeroSuppressionParameters();
+///     ULong64_t hash = TRestLegacyObservableCache::GetParameterHash(parameters);
+///
+///     TRestLegacyObservableCache cache;
+///     cache.Open("observables.cache");
+///     // For each event
+///     auto values = cache.ComputeObservables(parameters, data, nBins);
+///     cache.Add(runId, eventId, hash, values);
+///     cache.Write("observables.cache");
+///
+///     // Later, only the needed columns are read
+///     auto rows = cache.GetRows(hash);
+///     const Double_t* integral = cache.GetColumn(TRestLegacyObservableCache::kIntegral);
+///     for (Long64_t row = rows.first; row < rows.second; row++) histogram->Fill(integral[row]);
+/// \endcode
+///
+/// The cache file is memory-mapped. It contains a header followed by one
+/// contiguous array per column: the parameter hashes, one array of doubles
+/// per observable, the run ids and the event ids. Therefore, a loop
+/// over an observable only reads the pages of that column. The rows are
+/// sorted by parameter hash, run id and event id, so that the rows of a
+/// parameter set, or of a run, are contiguous and are found by binary
+/// search. The layout is native endian, and it is meant to be used on the
+/// machine that created it.
+///
+/// ComputeObservables selects the zero suppression kernel (see
+/// TRestLegacySpecializedZeroSuppression) once for each parameter set and
+/// trace length, and keeps it for the following events. It is not thread
+/// safe, so each thread must use its own cache object.
+///
+/// Add keeps the events in memory. Write merges them with the contents of
+/// the mapped file, replacing events already present, writes the result to
+/// a temporary file which is renamed, and maps it.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyObservableCache.
+///
+/// \class      TRestLegacyObservableCache
+///
+/// <hr>
+///
+
+#include "TRestLegacyObservableCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+#include "TRestLegacySpecializedZeroSuppression.h"
+
+namespace {
+
+const char kCacheMagic[8] = {'R', 'L', 'E', 'G', 'O', 'B', 'S', '\0'};
+const UInt_t kCacheVersion = 1;
+
+struct CacheHeader {
+    char fMagic[8];
+    UInt_t fVersion;
+    UInt_t fNObservables;
+    Long64_t fNRows;
+};
+
+template <typename T>
+bool WriteColumn(FILE* out, const std::vector<T>& column) {
+    return fwrite(column.data(), sizeof(T), column.size(), out) == column.size();
+}
+
+/// FNV-1a hash of the raw bytes of a value
+template <typename T>
+void HashValue(ULong64_t& hash, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t n = 0; n < sizeof(T); n++) {
+        hash ^= bytes[n];
+        hash *= 1099511628211ULL;
+    }
+}
+}  // namespace
+
+std::string TRestLegacyObservableCache::GetObservableName(Observable observable) {
+    switch (observable) {
+        case kNumberOfSignals:
+            return "NumberOfSignals";
+        case kNumberOfPoints:
+            return "NumberOfPoints";
+        case kBaseLineMean:
+            return "BaseLineMean";
+        case kBaseLineSigmaMean:
+            return "BaseLineSigmaMean";
+        case kIntegral:
+            return "Integral";
+        default:
+            return "";
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It returns a hash identifying a set of zero suppression parameters
+///
+/// Two parameter sets have the same hash when all their values are the same.
+///
+ULong64_t TRestLegacyObservableCache::GetParameterHash(
+    const TRestLegacyZeroSuppression::Parameters& parameters) {
+    ULong64_t hash = 14695981039346656037ULL;
+    HashValue(hash, parameters.fBaseLineStart);
+    HashValue(hash, parameters.fBaseLineEnd);
+    HashValue(hash, parameters.fIntegralStart);
+    HashValue(hash, parameters.fIntegralEnd);
+    HashValue(hash, parameters.fPointThreshold);
+    HashValue(hash, parameters.fSignalThreshold);
+    HashValue(hash, parameters.fNPointsOverThreshold);
+    HashValue(hash, parameters.fNPointsFlatThreshold);
+    return hash;
+}
+
+///////////////////////////////////////////////
+/// \brief It computes the observables of an event from its raw signals
+///
+/// Signal `n` has `nBins[n]` bins starting at `data[n]`. Signals may have different lengths.
+///
+TRestLegacyObservableCache::Values TRestLegacyObservableCache::ComputeObservables(
+    const TRestLegacyZeroSuppression::Parameters& parameters, const std::vector<const Short_t*>& data,
+    const std::vector<Int_t>& nBins) {
+    Values values{};
+    const ULong64_t parameterHash = GetParameterHash(parameters);
+
+    for (size_t s = 0; s < data.size(); s++) {
+        const auto& zeroSuppression = GetZeroSuppression(parameters, parameterHash, nBins[s]);
+        TRestLegacyZeroSuppression::BaseLine baseLine = zeroSuppression.Suppress(data[s], nBins[s], fPoints);
+        values[kBaseLineMean] += baseLine.fMean;
+        values[kBaseLineSigmaMean] += baseLine.fSigma;
+        if (fPoints.empty()) continue;
+
+        values[kNumberOfSignals]++;
+        values[kNumberOfPoints] += fPoints.size();
+        for (Int_t point : fPoints) values[kIntegral] += data[s][point] - baseLine.fMean;
+    }
+
+    if (!data.empty()) {
+        values[kBaseLineMean] /= data.size();
+        values[kBaseLineSigmaMean] /= data.size();
+    }
+    return values;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the zero suppression for traces of `nBins` bins, creating it the first time
+///
+/// The zero suppressions of previous parameter sets are discarded when the parameters change.
+///
+const TRestLegacySpecializedZeroSuppression& TRestLegacyObservableCache::GetZeroSuppression(
+    const TRestLegacyZeroSuppression::Parameters& parameters, ULong64_t parameterHash, Int_t nBins) {
+    if (parameterHash != fZeroSuppressionHash) {
+        fZeroSuppressions.clear();
+        fZeroSuppressionHash = parameterHash;
+    }
+
+    for (const auto& zeroSuppression : fZeroSuppressions)
+        if (zeroSuppression.GetNumberOfBins() == nBins) return zeroSuppression;
+
+    fZeroSuppressions.emplace_back(parameters, nBins);
+    return fZeroSuppressions.back();
+}
+
+void TRestLegacyObservableCache::Unmap() {
+    if (fMappedData != nullptr) munmap(fMappedData, fMappedSize);
+    fMappedData = nullptr;
+    fMappedSize = 0;
+    fParameterHashes = nullptr;
+    fRunIds = nullptr;
+    fEventIds = nullptr;
+    fColumns.fill(nullptr);
+    fNRows = 0;
+}
+
+///////////////////////////////////////////////
+/// \brief It maps an existing cache file. It returns false if the file is missing or not valid.
+///
+/// Events added and not written yet are kept.
+///
+bool TRestLegacyObservableCache::Open(const std::string& cacheFile) {
+    Unmap();
+
+    int fd = open(cacheFile.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(CacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    fMappedData = data;
+    fMappedSize = status.st_size;
+
+    const CacheHeader* header = static_cast<const CacheHeader*>(fMappedData);
+    const size_t nRows = header->fNRows;
+    size_t expectedSize = sizeof(CacheHeader) + nRows * (sizeof(ULong64_t) + 2 * sizeof(Int_t)) +
+                          nRows * kNObservables * sizeof(Double_t);
+    if (memcmp(header->fMagic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header->fVersion != kCacheVersion ||
+        header->fNObservables != kNObservables || expectedSize != fMappedSize) {
+        Unmap();
+        return false;
+    }
+
+    // The 8-byte columns go first, so that every column is aligned
+    const char* position = static_cast<const char*>(fMappedData) + sizeof(CacheHeader);
+    fParameterHashes = reinterpret_cast<const ULong64_t*>(position);
+    position += nRows * sizeof(ULong64_t);
+    for (auto& column : fColumns) {
+        column = reinterpret_cast<const Double_t*>(position);
+        position += nRows * sizeof(Double_t);
+    }
+    fRunIds = reinterpret_cast<const Int_t*>(position);
+    position += nRows * sizeof(Int_t);
+    fEventIds = reinterpret_cast<const Int_t*>(position);
+
+    fNRows = nRows;
+    fCacheFile = cacheFile;
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It adds the observables of an event. They are written to the cache file by Write.
+///
+void TRestLegacyObservableCache::Add(Int_t runId, Int_t eventId, ULong64_t parameterHash,
+                                     const Values& values) {
+    fPending.push_back({parameterHash, runId, eventId, values});
+}
+
+///////////////////////////////////////////////
+/// \brief It writes the mapped events and the added events to `cacheFile`, and maps it
+///
+/// An added event replaces a mapped event with the same run id, event id and parameter hash.
+///
+bool TRestLegacyObservableCache::Write(const std::string& cacheFile) {
+    std::vector<Row> rows;
+    rows.reserve(fNRows + fPending.size());
+    for (Long64_t n = 0; n < fNRows; n++) {
+        Row row{fParameterHashes[n], fRunIds[n], fEventIds[n], {}};
+        for (Int_t o = 0; o < kNObservables; o++) row.fValues[o] = fColumns[o][n];
+        rows.push_back(row);
+    }
+    rows.insert(rows.end(), fPending.begin(), fPending.end());
+
+    // After a stable sort, the last row of each key is the most recently added
+    auto key = [](const Row& row) { return std::make_tuple(row.fParameterHash, row.fRunId, row.fEventId); };
+    std::stable_sort(rows.begin(), rows.end(), [&](const Row& a, const Row& b) { return key(a) < key(b); });
+    std::vector<Row> unique;
+    unique.reserve(rows.size());
+    for (size_t n = 0; n < rows.size(); n++)
+        if (n + 1 == rows.size() || key(rows[n]) != key(rows[n + 1])) unique.push_back(rows[n]);
+    rows.clear();
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.fMagic, kCacheMagic, sizeof(kCacheMagic));
+    header.fVersion = kCacheVersion;
+    header.fNObservables = kNObservables;
+    header.fNRows = unique.size();
+
+    // The cache is written to a temporary file and renamed, so that readers never see a partial cache
+    std::string temporaryFile = cacheFile + ".tmp";
+    FILE* out = fopen(temporaryFile.c_str(), "wb");
+    if (out == nullptr) return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    std::vector<ULong64_t> hashes;
+    for (const auto& row : unique) hashes.push_back(row.fParameterHash);
+    ok &= WriteColumn(out, hashes);
+    std::vector<Double_t> column(unique.size());
+    for (Int_t o = 0; o < kNObservables; o++) {
+        for (size_t n = 0; n < unique.size(); n++) column[n] = unique[n].fValues[o];
+        ok &= WriteColumn(out, column);
+    }
+    std::vector<Int_t> ids(unique.size());
+    for (size_t n = 0; n < unique.size(); n++) ids[n] = unique[n].fRunId;
+    ok &= WriteColumn(out, ids);
+    for (size_t n = 0; n < unique.size(); n++) ids[n] = unique[n].fEventId;
+    ok &= WriteColumn(out, ids);
+    ok &= fclose(out) == 0;
+
+    if (!ok || rename(temporaryFile.c_str(), cacheFile.c_str()) != 0) {
+        remove(temporaryFile.c_str());
+        return false;
+    }
+
+    fPending.clear();
+    return Open(cacheFile);
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the first row whose key is not lower than the given one
+///
+Long64_t TRestLegacyObservableCache::LowerBound(ULong64_t parameterHash, Int_t runId, Int_t eventId) const {
+    auto target = std::make_tuple(parameterHash, runId, eventId);
+    Long64_t first = 0;
+    Long64_t count = fNRows;
+    while (count > 0) {
+        Long64_t step = count / 2;
+        Long64_t row = first + step;
+        if (std::make_tuple(fParameterHashes[row], fRunIds[row], fEventIds[row]) < target) {
+            first = row + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the rows [first, second) computed with the given parameter set
+///
+std::pair<Long64_t, Long64_t> TRestLegacyObservableCache::GetRows(ULong64_t parameterHash) const {
+    const Int_t lowest = std::numeric_limits<Int_t>::min();
+    Long64_t first = LowerBound(parameterHash, lowest, lowest);
+    Long64_t last = parameterHash == std::numeric_limits<ULong64_t>::max()
+                        ? fNRows
+                        : LowerBound(parameterHash + 1, lowest, lowest);
+    return {first, last};
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the rows [first, second) of a run computed with the given parameter set
+///
+std::pair<Long64_t, Long64_t> TRestLegacyObservableCache::GetRows(ULong64_t parameterHash,
+                                                                  Int_t runId) const {
+    const Int_t lowest = std::numeric_limits<Int_t>::min();
+    Long64_t first = LowerBound(parameterHash, runId, lowest);
+    Long64_t last = runId == std::numeric_limits<Int_t>::max() ? GetRows(parameterHash).second
+                                                               : LowerBound(parameterHash, runId + 1, lowest);
+    return {first, last};
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the row of an event, or -1 if it is not in the cache
+///
+Long64_t TRestLegacyObservableCache::Find(ULong64_t parameterHash, Int_t runId, Int_t eventId) const {
+    Long64_t row = LowerBound(parameterHash, runId, eventId);
+    if (row < fNRows && fParameterHashes[row] == parameterHash && fRunIds[row] == runId &&
+        fEventIds[row] == eventId)
+        return row;
+    return -1;
+}
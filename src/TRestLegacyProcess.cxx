@@ -24,8 +24,45 @@
 /// The TRestLegacyProcess is the base class for legacy processes, which
 /// stands for processes which are not part of REST anymore but they are
 /// kept to keep backward compatibility with previous REST realeases.
-/// The creation of a legacy process is not allowed, you will have some
-/// errors and warnings in case you attempt to run a legacy process.
+///
+/// Legacy processes found in a processing chain are not executed by
+/// themselves. Each legacy process registers the name of the process that
+/// implements its algorithm nowadays by defining, at namespace scope in its
+/// source file, a TRestLegacyProcess::SuccessorRegistration object:
+///
+/// \code
+///     namespace {
+///     const TRestLegacyProcess::SuccessorRegistration kSuccessorRegistration(
+///         "TRestRawZeroSuppresionProcess", "TRestRawToDetectorSignalProcess");
+///     }
+/// \endcode
+///
+/// Registrations are only accepted during static initialization, before
+/// the registry is read for the first time. The first time the process is
+/// required by the chain, an instance of the successor is created. At
+/// InitProcess, once the legacy parameters have been loaded, they are
+/// translated into the successor by the TranslateMembers method implemented
+/// by each legacy class, and the process context (run, analysis tree,
+/// observables, verbose level, host manager, friendly and parallel
+/// processes) is forwarded to it. Afterwards, InitProcess, ProcessEvent and
+/// EndProcess are directly forwarded to the successor, so that archived RML
+/// configurations can be reprocessed without any extra copy of the event
+/// data.
+///
+/// The library defining the successor must be available, i.e. loaded or
+/// reachable through the ROOT autoloading mechanism. Otherwise, InitProcess
+/// throws an exception, before any event has been processed.
+///
+/// The deprecation warning of each legacy class is printed only once per
+/// job. Instead, the number of instances of each legacy class is counted,
+/// whichever the way the objects are created, and can be retrieved through
+/// GetInstanceCounts. The legacy readers, TRestLegacyCatalog and
+/// TRestLegacyProcessPool, also count the files they read legacy objects
+/// from and the time spent reading them, retrieved through
+/// GetNumberOfReaderFiles and GetReaderStreamingTime. Objects read directly
+/// with TKey::ReadObj are only counted as instances. A summary is printed
+/// at the end of any job that created legacy objects.
+///
 /// RESTsoft - Software for Rare Event Searches with TPCs
 ///
 ///----------------------------------------------------------------------
@@ -37,6 +74,10 @@
 /// 2022-05: First implementation of TRestLegacyProcess
 /// JuanAn Garcia
 ///
+/// 2026-10: Legacy processes are forwarded to their successor process
+///
+/// 2026-10: Deprecation warnings printed once, and legacy usage counters
+///
 /// \class TRestLegacyProcess
 /// \author: JuanAn Garcia. Write full name and e-mail: juanangp@unizar.es
 ///
@@ -45,4 +86,262 @@
 
 #include "TRestLegacyProcess.h"
 
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
 ClassImp(TRestLegacyProcess);
+
+/// The information kept for each legacy class. Entries are only added during static initialization,
+/// through SuccessorRegistration. Once the registry has been read it is frozen, so that it can be
+/// read without locks, and the counters are atomic.
+struct TRestLegacyProcess::LegacyClassEntry {
+    std::string fSuccessorName;
+    std::atomic<ULong64_t> fInstances{0};
+    std::atomic<bool> fWarned{false};
+};
+
+namespace {
+std::atomic<ULong64_t> gReaderFiles{0};
+std::atomic<ULong64_t> gReaderStreamingNanoseconds{0};
+std::atomic<bool> gSummaryRegistered{false};
+std::atomic<bool> gRegistryFrozen{false};
+}  // namespace
+
+///////////////////////////////////////////////
+/// \brief It returns the registry of legacy classes, relating each legacy class name to its
+/// successor class name and usage counters.
+///
+std::map<std::string, TRestLegacyProcess::LegacyClassEntry, std::less<>>& TRestLegacyProcess::GetRegistry() {
+    static std::map<std::string, LegacyClassEntry, std::less<>> registry;
+    return registry;
+}
+
+///////////////////////////////////////////////
+/// \brief It registers the process class that implements nowadays the algorithm of a legacy process.
+///
+/// It is called during static initialization, through a SuccessorRegistration defined at the legacy
+/// process source file. Registrations after the registry has been read are rejected, since the
+/// registry is read without locks.
+///
+bool TRestLegacyProcess::RegisterSuccessor(const std::string& legacyName, const std::string& successorName) {
+    if (gRegistryFrozen.load()) {
+        RESTError << "Successor of " << legacyName << " registered after static initialization. Ignored"
+                  << RESTendl;
+        return false;
+    }
+    GetRegistry()[legacyName].fSuccessorName = successorName;
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the successor class name of a legacy process, or an empty string if none
+/// is registered.
+///
+std::string TRestLegacyProcess::GetSuccessorName(const std::string& legacyName) {
+    gRegistryFrozen = true;
+    const auto& registry = GetRegistry();
+    auto it = registry.find(legacyName);
+    if (it == registry.end()) return "";
+    return it->second.fSuccessorName;
+}
+
+///////////////////////////////////////////////
+/// \brief It counts a new instance of a legacy class. It is called by the legacy process constructors.
+///
+/// The deprecation warning of each legacy class is printed only the first time. Legacy objects
+/// are created each time they are read from a file, so printing it for every instance would
+/// flood the output when reading large amounts of files. The first call also registers
+/// PrintUsageSummary to be called at the end of the job.
+///
+void TRestLegacyProcess::CountInstance(const char* legacyName) {
+    gRegistryFrozen = true;
+    auto& registry = GetRegistry();
+    auto it = registry.find(legacyName);
+    if (it == registry.end()) return;
+
+    it->second.fInstances++;
+    if (!it->second.fWarned.exchange(true)) {
+        RESTWarning << "Creating legacy process " << legacyName << RESTendl;
+        RESTWarning << "This process is now implemented under " << it->second.fSuccessorName << RESTendl;
+    }
+
+    if (!gSummaryRegistered.exchange(true)) std::atexit(PrintUsageSummary);
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the number of instances created for each legacy class
+///
+std::vector<std::pair<std::string, ULong64_t>> TRestLegacyProcess::GetInstanceCounts() {
+    std::vector<std::pair<std::string, ULong64_t>> counts;
+    gRegistryFrozen = true;
+    for (const auto& entry : GetRegistry()) counts.emplace_back(entry.first, entry.second.fInstances.load());
+    return counts;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the number of files from which the legacy readers have read legacy objects
+///
+ULong64_t TRestLegacyProcess::GetNumberOfReaderFiles() { return gReaderFiles.load(); }
+
+///////////////////////////////////////////////
+/// \brief It returns the time, in seconds, spent by the legacy readers reading legacy objects
+///
+Double_t TRestLegacyProcess::GetReaderStreamingTime() { return gReaderStreamingNanoseconds.load() * 1.e-9; }
+
+///////////////////////////////////////////////
+/// \brief It counts a file from which legacy objects have been read. Used by the legacy readers.
+///
+void TRestLegacyProcess::AddReaderFile() { gReaderFiles++; }
+
+///////////////////////////////////////////////
+/// \brief It adds the time, in seconds, spent reading legacy objects. Used by the legacy readers.
+///
+void TRestLegacyProcess::AddReaderStreamingTime(Double_t seconds) {
+    gReaderStreamingNanoseconds += (ULong64_t)(seconds * 1.e9);
+}
+
+///////////////////////////////////////////////
+/// \brief It prints the legacy usage counters
+///
+/// It is called automatically at the end of any job where a legacy object was created. It is a
+/// static function, so there is no object whose verbose level applies, and it prints to std::cout.
+///
+/// It runs during static destruction. The registry is constructed, at the latest, by the first
+/// CountInstance call, before PrintUsageSummary is registered with std::atexit, so it is destroyed
+/// after the summary is printed. The reader counters are trivially destructible.
+///
+void TRestLegacyProcess::PrintUsageSummary() {
+    std::cout << "Legacy library usage summary" << std::endl;
+    for (const auto& count : GetInstanceCounts())
+        if (count.second > 0)
+            std::cout << " - " << count.first << " instances : " << count.second << std::endl;
+    std::cout << " - Files read by the legacy catalog and pool : " << GetNumberOfReaderFiles() << std::endl;
+    std::cout << " - Time reading them : " << GetReaderStreamingTime() << " s" << std::endl;
+}
+
+///////////////////////////////////////////////
+/// \brief It creates the successor process, without translating the legacy data members.
+///
+/// The successor is created only once. Further calls return the existing instance. The event
+/// types may be required by the processing chain before InitProcess, so the successor may be
+/// created before the legacy parameters are loaded. See TranslateSuccessor.
+///
+TRestEventProcess* TRestLegacyProcess::InstantiateSuccessor() const {
+    if (fSuccessor != nullptr) return fSuccessor;
+
+    std::string successorName = GetSuccessorName(ClassName());
+    if (successorName.empty()) {
+        RESTError << ClassName() << " has no registered successor process" << RESTendl;
+        return nullptr;
+    }
+
+    TClass* cl = TClass::GetClass(successorName.c_str());
+    if (cl == nullptr || !cl->InheritsFrom(TRestEventProcess::Class())) {
+        RESTError << "Successor process " << successorName << " of " << ClassName() << " is not available"
+                  << RESTendl;
+        RESTError << "Make sure the library implementing " << successorName << " is compiled" << RESTendl;
+        return nullptr;
+    }
+
+    fSuccessor = static_cast<TRestEventProcess*>(cl->New());
+    RESTInfo << ClassName() << " : " << GetName() << " will be executed by " << successorName << RESTendl;
+
+    return fSuccessor;
+}
+
+///////////////////////////////////////////////
+/// \brief It creates the successor process, if needed, and translates the legacy data members into it.
+///
+/// The members are translated only once, so it must be called after the legacy parameters are loaded.
+///
+TRestEventProcess* TRestLegacyProcess::TranslateSuccessor() const {
+    TRestEventProcess* successor = InstantiateSuccessor();
+    if (successor == nullptr || fSuccessorTranslated) return successor;
+
+    successor->SetName(GetName());
+    successor->SetTitle(GetTitle());
+    TranslateMembers(successor);
+    fSuccessorTranslated = true;
+    return successor;
+}
+
+///////////////////////////////////////////////
+/// \brief It gives the successor the context this process received from the processing chain
+///
+void TRestLegacyProcess::ForwardContext(TRestEventProcess* successor) {
+    successor->SetRunInfo(fRunInfo);
+    successor->SetAnalysisTree(fAnalysisTree);
+    successor->SetHostmgr(GetHostmgr());
+    successor->SetVerboseLevel(GetVerboseLevel());
+    for (auto process : fFriendlyProcesses) successor->SetFriendProcess(process);
+    for (auto process : fParallelProcesses) successor->SetParallelProcess(process);
+
+    // The observables requested at the RML, including observable="all", are defined for this process
+    SetSuccessorMember(successor, "fDynamicObs", fDynamicObs);
+    SetSuccessorMember(successor, "fObservablesDefined", fObservablesDefined);
+}
+
+RESTValue TRestLegacyProcess::GetInputEvent() const {
+    TRestEventProcess* successor = InstantiateSuccessor();
+    if (successor == nullptr) return RESTValue((TRestEvent*)nullptr);
+    return successor->GetInputEvent();
+}
+
+RESTValue TRestLegacyProcess::GetOutputEvent() const {
+    TRestEventProcess* successor = InstantiateSuccessor();
+    if (successor == nullptr) return RESTValue((TRestEvent*)nullptr);
+    return successor->GetOutputEvent();
+}
+
+///////////////////////////////////////////////
+/// \brief It translates the legacy parameters into the successor process, and initializes it.
+///
+/// A legacy process without an available successor cannot be executed. In that case an
+/// exception is thrown here, before any event has been processed.
+///
+void TRestLegacyProcess::InitProcess() {
+    TRestEventProcess* successor = TranslateSuccessor();
+    if (successor == nullptr) {
+        RESTError << "Legacy process " << ClassName() << " : " << GetName()
+                  << " cannot be executed without its successor process" << RESTendl;
+        throw std::runtime_error(std::string("No successor process available for ") + ClassName());
+    }
+
+    ForwardContext(successor);
+    successor->InitProcess();
+}
+
+///////////////////////////////////////////////
+/// \brief The event is directly forwarded to the successor process.
+///
+TRestEvent* TRestLegacyProcess::ProcessEvent(TRestEvent* eventInput) {
+    if (fSuccessor == nullptr || !fSuccessorTranslated) {
+        RESTError << ClassName() << "::ProcessEvent. InitProcess was not called" << RESTendl;
+        return nullptr;
+    }
+    return fSuccessor->ProcessEvent(eventInput);
+}
+
+void TRestLegacyProcess::EndProcess() {
+    if (fSuccessor != nullptr) fSuccessor->EndProcess();
+}
+
+///////////////////////////////////////////////
+/// \brief It appends to `content` a binary representation of the data stored in this object.
+///
+/// Two legacy objects with the same content are identical for any practical purpose. It is used
+/// by TRestLegacyProcessPool to share identical objects. Legacy processes must call the base
+/// implementation and append the value of each of their data members.
+///
+void TRestLegacyProcess::AppendContent(std::string& content) const {
+    content.append(ClassName());
+    content.push_back('\0');
+    content.append(GetName());
+    content.push_back('\0');
+    content.append(GetTitle());
+    content.push_back('\0');
+}
+
+TRestLegacyProcess::~TRestLegacyProcess() { delete fSuccessor; }
@@ -0,0 +1,193 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyProcessPool allows to share a single instance among all the
+/// identical legacy process objects read from a chain of run files.
+///
+/// When thousands of runs are chained, each file provides its own copy of
+/// the legacy process metadata, although nearly all of them contain the
+/// same parameters. Intern takes ownership of a legacy object and returns
+/// a reference counted pointer. If an identical object is already in the
+/// pool, the given object is deleted and the existing one is returned
+/// instead. Two objects are identical when their content, as given by
+/// TRestLegacyProcess::AppendContent (class name, name, title and every
+/// data member), is the same. The object is deleted, and removed from the
+/// pool, when the last reference is released.
+///
+/// The returned objects are shared by every holder, so they are given as
+/// const and only the getters can be used. GetSuccessor and the event
+/// getters are const, but they create the successor process, which would
+/// also be shared. A pooled process to be executed in a processing chain,
+/// or modified, must be cloned first.
+///
+/// \code
+///     auto& pool = TRestLegacyProcessPool::Instance();
+///     std::vector<std::shared_ptr<const TRestLegacyProcess>> processes;
+///     for (const auto& run : runFiles) {
+///         TFile* file = TFile::Open(run.c_str());
+///         processes.push_back(pool.Read(file, "zS"));
+///         delete file;
+///     }
+///     auto zs = dynamic_cast<const TRestRawZeroSuppresionProcess*>(processes[0].get());
+///     if (zs != nullptr) cout << zs->GetPointThreshold() << endl;
+/// \endcode
+///
+/// The pool is thread safe.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyProcessPool.
+///
+/// \class      TRestLegacyProcessPool
+///
+/// <hr>
+///
+
+#include "TRestLegacyProcessPool.h"
+
+#include <TFile.h>
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "TRestLegacyProcess.h"
+
+struct TRestLegacyProcessPool::State {
+    std::mutex fMutex;
+    std::unordered_map<std::string, std::weak_ptr<const TRestLegacyProcess>> fObjects;
+    ULong64_t fRequests = 0;
+    ULong64_t fHits = 0;
+
+    /// The names of the files legacy objects have been read from, so that each file is counted once
+    std::unordered_set<std::string> fFiles;
+
+    /// It removes the entry of an object whose last reference has been released
+    void Release(const std::string& content) {
+        std::lock_guard<std::mutex> lock(fMutex);
+        auto it = fObjects.find(content);
+        // The entry may have been taken meanwhile by a new identical object
+        if (it != fObjects.end() && it->second.expired()) fObjects.erase(it);
+    }
+};
+
+TRestLegacyProcessPool::TRestLegacyProcessPool() : fState(std::make_shared<State>()) {}
+
+///////////////////////////////////////////////
+/// \brief It returns the pool shared by the whole application
+///
+TRestLegacyProcessPool& TRestLegacyProcessPool::Instance() {
+    static TRestLegacyProcessPool pool;
+    return pool;
+}
+
+///////////////////////////////////////////////
+/// \brief It takes ownership of `process` and returns the shared instance identical to it
+///
+/// If an identical object is already in the pool, `process` is deleted.
+///
+std::shared_ptr<const TRestLegacyProcess> TRestLegacyProcessPool::Intern(TRestLegacyProcess* process) {
+    if (process == nullptr) return nullptr;
+
+    std::string content;
+    process->AppendContent(content);
+
+    std::shared_ptr<const TRestLegacyProcess> shared;
+    {
+        std::lock_guard<std::mutex> lock(fState->fMutex);
+        fState->fRequests++;
+
+        auto& entry = fState->fObjects[content];
+        shared = entry.lock();
+        if (shared) {
+            fState->fHits++;
+        } else {
+            std::shared_ptr<State> state = fState;
+            auto release = [state, content](TRestLegacyProcess* p) {
+                delete p;
+                state->Release(content);
+            };
+            shared = std::shared_ptr<const TRestLegacyProcess>(process, release);
+            entry = shared;
+            return shared;
+        }
+    }
+
+    delete process;
+    return shared;
+}
+
+///////////////////////////////////////////////
+/// \brief It reads the legacy process `name` from `file` and returns its shared instance
+///
+/// It returns nullptr if the object does not exist or it is not a legacy process. Each file is
+/// counted once by TRestLegacyProcess::AddReaderFile, however many objects are read from it.
+///
+std::shared_ptr<const TRestLegacyProcess> TRestLegacyProcessPool::Read(TFile* file, const std::string& name) {
+    auto start = std::chrono::steady_clock::now();
+    TObject* obj = file->Get(name.c_str());
+    TRestLegacyProcess* process = dynamic_cast<TRestLegacyProcess*>(obj);
+    if (process == nullptr) {
+        delete obj;
+        return nullptr;
+    }
+    TRestLegacyProcess::AddReaderStreamingTime(
+        std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count());
+
+    bool newFile = false;
+    {
+        std::lock_guard<std::mutex> lock(fState->fMutex);
+        newFile = fState->fFiles.insert(file->GetName()).second;
+    }
+    if (newFile) TRestLegacyProcess::AddReaderFile();
+    return Intern(process);
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the number of distinct objects alive in the pool
+///
+size_t TRestLegacyProcessPool::GetNumberOfObjects() const {
+    std::lock_guard<std::mutex> lock(fState->fMutex);
+    return fState->fObjects.size();
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the number of objects given to the pool
+///
+ULong64_t TRestLegacyProcessPool::GetNumberOfRequests() const {
+    std::lock_guard<std::mutex> lock(fState->fMutex);
+    return fState->fRequests;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the number of objects given to the pool that were replaced by an identical one
+///
+ULong64_t TRestLegacyProcessPool::GetNumberOfHits() const {
+    std::lock_guard<std::mutex> lock(fState->fMutex);
+    return fState->fHits;
+}
@@ -0,0 +1,303 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacySpecializedZeroSuppression applies the legacy zero
+/// suppression, described at TRestLegacyZeroSuppression, with kernels
+/// compiled for the parameter sets most archived runs were taken with.
+///
+/// In a specialized kernel the trace length, the baseline and integral
+/// ranges and the minimum number of points over threshold are template
+/// parameters. The loops over the baseline and integral ranges have a
+/// fixed trip count and are unrolled by the compiler. The baseline sums are
+/// exact integer sums, calculated with SSE2 when available. The bins of
+/// the integral range over threshold are found in a single branch-free
+/// pass, comparing the raw ADC values against the smallest ADC value over
+/// threshold, and stored as a bit mask. The pulses are then walked through
+/// the bit mask, without any check of the trace length. The thresholds are
+/// not fixed, as they are not shared among runs.
+///
+/// The kernel is selected once, when the object is created from the
+/// parameters stored in a TRestRawZeroSuppresionProcess and the trace
+/// length of the raw data. Ranges are compared after being clamped to the
+/// trace, as the legacy algorithm does. When no specialization matches, or
+/// a signal has a different length, the generic kernel is used instead.
+/// All kernels produce bit-identical results.
+///
+/// \code
+///     TRestLegacySpecializedZeroSuppression zs(zsProcess->GetZeroSuppressionParameters(), nBins);
+///     std::vector<Int_t> points;
+///     zs.Suppress(data, nBins, points);
+/// \endcode
+///
+/// New parameter sets are added to the list at GetEntries, in this file.
+/// The parameter sets present in a list of run files may be obtained with
+/// restLegacyCatalog.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacySpecializedZeroSuppression.
+///
+/// \class      TRestLegacySpecializedZeroSuppression
+///
+/// <hr>
+///
+
+#include "TRestLegacySpecializedZeroSuppression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+using ZeroSuppression = TRestLegacyZeroSuppression;
+
+/// It returns the range [start, end) clamped to a trace of `nBins` bins, or (0, 0) if it is empty
+constexpr std::pair<Int_t, Int_t> ClampRange(Int_t start, Int_t end, Int_t nBins) {
+    start = std::max(start, 0);
+    end = std::min(end, nBins);
+    return end > start ? std::make_pair(start, end) : std::make_pair(0, 0);
+}
+
+/// It adds the values in the range [Start, End) and their squares. Both sums are exact.
+template <Int_t Start, Int_t End>
+inline void SumBaseLine(const Short_t* data, Long64_t& sum, Long64_t& sumSquares) {
+    Int_t i = Start;
+#ifdef __SSE2__
+    // The sum of up to 65535 values fits in the Int_t lanes. Pairwise sums of squares are in
+    // [0, 2^31], so they are zero-extended to 64 bits before accumulation.
+    static_assert(End - Start < 65536, "The baseline range is too long for 32-bit sums");
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    __m128i squares = zero;
+    for (; i + 8 <= End; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        sums = _mm_add_epi32(sums, _mm_madd_epi16(x, ones));
+        __m128i pairs = _mm_madd_epi16(x, x);
+        squares = _mm_add_epi64(squares, _mm_unpacklo_epi32(pairs, zero));
+        squares = _mm_add_epi64(squares, _mm_unpackhi_epi32(pairs, zero));
+    }
+
+    alignas(16) Int_t sumLanes[4];
+    alignas(16) Long64_t squareLanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(sumLanes), sums);
+    _mm_store_si128(reinterpret_cast<__m128i*>(squareLanes), squares);
+    sum += (Long64_t)sumLanes[0] + sumLanes[1] + sumLanes[2] + sumLanes[3];
+    sumSquares += squareLanes[0] + squareLanes[1];
+#endif
+    for (; i < End; i++) {
+        sum += data[i];
+        sumSquares += (Int_t)data[i] * data[i];
+    }
+}
+
+/// It returns a mask with bit j set when `data[j] >= minimumADC`, for the 64 values starting at
+/// `data`. `minimumADC` must not be above the Short_t range.
+inline ULong64_t GetOverThresholdMask(const Short_t* data, Int_t minimumADC) {
+#ifdef __SSE2__
+    if (minimumADC > std::numeric_limits<Short_t>::min()) {
+        const __m128i cut = _mm_set1_epi16((Short_t)(minimumADC - 1));
+        ULong64_t bits = 0;
+        for (Int_t j = 0; j < 64; j += 16) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + j));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + j + 8));
+            low = _mm_cmpgt_epi16(low, cut);
+            high = _mm_cmpgt_epi16(high, cut);
+            bits |= (ULong64_t)(UInt_t)_mm_movemask_epi8(_mm_packs_epi16(low, high)) << j;
+        }
+        return bits;
+    }
+#endif
+    ULong64_t bits = 0;
+    for (Int_t j = 0; j < 64; j++) bits |= (ULong64_t)(data[j] >= minimumADC) << j;
+    return bits;
+}
+
+template <Int_t NBins, Int_t BaseLineStart, Int_t BaseLineEnd, Int_t IntegralStart, Int_t IntegralEnd,
+          Int_t NPointsOverThreshold>
+ZeroSuppression::BaseLine SuppressSpecialized(const Short_t* data,
+                                              const ZeroSuppression::Parameters& parameters,
+                                              std::vector<Int_t>& points) {
+    constexpr Int_t kBaseLineStart = ClampRange(BaseLineStart, BaseLineEnd, NBins).first;
+    constexpr Int_t kBaseLineEnd = ClampRange(BaseLineStart, BaseLineEnd, NBins).second;
+    constexpr Int_t kStart = ClampRange(IntegralStart, IntegralEnd, NBins).first;
+    constexpr Int_t kEnd = ClampRange(IntegralStart, IntegralEnd, NBins).second;
+    constexpr Int_t kNFullWords = (kEnd - kStart) / 64;
+    constexpr Int_t kNTail = (kEnd - kStart) % 64;
+    constexpr Int_t kNWords = kNFullWords + (kNTail > 0);
+
+    points.clear();
+
+    ZeroSuppression::BaseLine baseLine;
+    if (kBaseLineEnd > kBaseLineStart) {
+        Long64_t sum = 0;
+        Long64_t sumSquares = 0;
+        SumBaseLine<kBaseLineStart, kBaseLineEnd>(data, sum, sumSquares);
+        baseLine = ZeroSuppression::GetBaseLine(sum, sumSquares, kBaseLineEnd - kBaseLineStart);
+    }
+    if (kNWords == 0) return baseLine;
+
+    const Double_t mean = baseLine.fMean;
+    const Double_t threshold = parameters.fPointThreshold * baseLine.fSigma;
+    const Double_t signalThreshold = parameters.fSignalThreshold * baseLine.fSigma;
+    const Int_t minimumADC = ZeroSuppression::GetMinimumADCOverThreshold(mean, threshold);
+
+    if (minimumADC > std::numeric_limits<Short_t>::max()) return baseLine;
+
+    // Bit j of word w is set when bin kStart + 64 * w + j is over threshold
+    ULong64_t over[kNWords > 0 ? kNWords : 1];
+    for (Int_t w = 0; w < kNFullWords; w++)
+        over[w] = GetOverThresholdMask(data + kStart + 64 * w, minimumADC);
+    if (kNTail > 0) {
+        const Short_t* word = data + kStart + 64 * kNFullWords;
+        ULong64_t bits = 0;
+        for (Int_t j = 0; j < kNTail; j++) bits |= (ULong64_t)(word[j] >= minimumADC) << j;
+        over[kNWords - 1] = bits;
+    }
+
+    auto isOver = [&](Int_t bin) { return (over[(bin - kStart) / 64] >> ((bin - kStart) % 64)) & 1; };
+    auto next = [&](Int_t bin) {
+        if (bin >= kEnd) return kEnd;
+        Int_t w = (bin - kStart) / 64;
+        ULong64_t bits = over[w] & (~0ULL << ((bin - kStart) % 64));
+        while (bits == 0) {
+            if (++w == kNWords) return kEnd;
+            bits = over[w];
+        }
+        return kStart + 64 * w + __builtin_ctzll(bits);
+    };
+    auto value = [&](Int_t bin) { return (Double_t)data[bin] - mean; };
+
+    Int_t i = next(kStart);
+    while (i < kEnd) {
+        Int_t pos = i;
+        Double_t sum = value(i);
+        Double_t sumSquares = value(i) * value(i);
+        i++;
+
+        Int_t flatN = 0;
+        while (i < kEnd && isOver(i)) {
+            if (std::abs(value(i) - value(i - 1)) > threshold)
+                flatN = 0;
+            else
+                flatN++;
+
+            if (flatN >= parameters.fNPointsFlatThreshold) break;
+
+            sum += value(i);
+            sumSquares += value(i) * value(i);
+            i++;
+        }
+
+        Int_t n = i - pos;
+        if (n >= NPointsOverThreshold) {
+            Double_t pulseMean = sum / n;
+            Double_t stdev = std::sqrt(sumSquares / n - pulseMean * pulseMean);
+            if (stdev > signalThreshold)
+                for (Int_t j = pos; j < i; j++) points.push_back(j);
+        }
+
+        // As in the legacy implementation, the bin following a pulse is never the start of a new pulse
+        i = next(i + 1);
+    }
+    return baseLine;
+}
+
+struct Entry {
+    TRestLegacySpecializedZeroSuppression::Specialization fSpecialization;
+    TRestLegacySpecializedZeroSuppression::Function fFunction;
+};
+
+template <Int_t NBins, Int_t BaseLineStart, Int_t BaseLineEnd, Int_t IntegralStart, Int_t IntegralEnd,
+          Int_t NPointsOverThreshold>
+Entry MakeEntry() {
+    return {{NBins, BaseLineStart, BaseLineEnd, IntegralStart, IntegralEnd, NPointsOverThreshold},
+            &SuppressSpecialized<NBins, BaseLineStart, BaseLineEnd, IntegralStart, IntegralEnd,
+                                 NPointsOverThreshold>};
+}
+
+/// The parameter sets with a specialized kernel: trace length, baseline range, integral range and
+/// number of points over threshold
+const std::vector<Entry>& GetEntries() {
+    static const std::vector<Entry> entries = {
+        // Default ranges of TRestRawZeroSuppresionProcess on AGET/AFTER traces
+        MakeEntry<512, 5, 55, 10, 500, 5>(),
+        MakeEntry<512, 5, 55, 10, 500, 3>(),
+        // Integral range covering the whole trace
+        MakeEntry<512, 5, 55, 10, 512, 5>(),
+        MakeEntry<512, 5, 55, 10, 512, 3>(),
+        MakeEntry<1024, 5, 55, 10, 1024, 5>(),
+    };
+    return entries;
+}
+}  // namespace
+
+TRestLegacySpecializedZeroSuppression::TRestLegacySpecializedZeroSuppression(
+    const TRestLegacyZeroSuppression::Parameters& parameters, Int_t nBins,
+    TRestLegacyZeroSuppression::Kernel kernel)
+    : fParameters(parameters), fNBins(nBins), fKernel(kernel) {
+    fFunction = FindSpecialization(parameters, nBins);
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the parameter sets with a specialized kernel
+///
+const std::vector<TRestLegacySpecializedZeroSuppression::Specialization>&
+TRestLegacySpecializedZeroSuppression::GetSpecializations() {
+    static const std::vector<Specialization> specializations = [] {
+        std::vector<Specialization> result;
+        for (const auto& entry : GetEntries()) result.push_back(entry.fSpecialization);
+        return result;
+    }();
+    return specializations;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the specialized kernel for traces of `nBins` bins, or nullptr if there is none
+///
+/// The baseline and integral ranges are compared after being clamped to the trace.
+///
+TRestLegacySpecializedZeroSuppression::Function TRestLegacySpecializedZeroSuppression::FindSpecialization(
+    const TRestLegacyZeroSuppression::Parameters& parameters, Int_t nBins) {
+    auto baseLineRange = ClampRange(parameters.fBaseLineStart, parameters.fBaseLineEnd, nBins);
+    auto integralRange = ClampRange(parameters.fIntegralStart, parameters.fIntegralEnd, nBins);
+
+    for (const auto& entry : GetEntries()) {
+        const Specialization& s = entry.fSpecialization;
+        if (s.fNBins == nBins && s.fNPointsOverThreshold == parameters.fNPointsOverThreshold &&
+            ClampRange(s.fBaseLineStart, s.fBaseLineEnd, nBins) == baseLineRange &&
+            ClampRange(s.fIntegralStart, s.fIntegralEnd, nBins) == integralRange)
+            return entry.fFunction;
+    }
+    return nullptr;
+}
@@ -0,0 +1,448 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyStreamer reads the TRestRawZeroSuppresionProcess and
+/// TRestRawSignalRecoverChannelsProcess objects stored in a file directly
+/// into a flat TRestLegacyCatalog::Record, without creating the objects.
+///
+/// Creating a legacy object through the ROOT streamers requires to build
+/// the full TRestEventProcess base chain, the TVector2 members and the
+/// channel id vectors, only to extract a few numbers. Instead, the key
+/// buffer is read and uncompressed into buffers reused from one object to
+/// the next, and the data members are decoded following the streamer info
+/// stored in the file for the class version of each object. Therefore,
+/// any historical class version is supported, as far as it is made of
+/// basic types, TVector2, `std::vector<Int_t>` and objects written with
+/// byte count, which are skipped. The decoding steps of each class
+/// version are built only once.
+///
+/// Decode returns false when an object cannot be decoded this way. The
+/// caller must then fall back to the standard TKey::ReadObj. Writing is
+/// not supported, legacy objects are only read.
+///
+/// \code
+///     TRestLegacyStreamer streamer;
+///     TRestLegacyCatalog::Record record;
+///     std::vector<Int_t> channels;
+///     if (!streamer.Decode(file, key, record, channels)) {
+///         // Use key->ReadObj()
+///     }
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyStreamer.
+///
+/// \class      TRestLegacyStreamer
+///
+/// <hr>
+///
+
+#include "TRestLegacyStreamer.h"
+
+#include <RZip.h>
+#include <TBufferFile.h>
+#include <TClass.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TStreamerElement.h>
+#include <TVector2.h>
+#include <TVirtualStreamerInfo.h>
+
+#include <cstring>
+
+namespace {
+
+enum StepKind { kUnsupported, kSkipCounted, kSkipTObject, kSkipTString, kVector2, kBasic, kIntVector };
+
+enum Field {
+    kNoField,
+    kBaseLineRange,
+    kIntegralRange,
+    kPointThreshold,
+    kSignalThreshold,
+    kSampling,
+    kNPointsOverThreshold,
+    kNPointsFlatThreshold,
+    kBaseLineCorrection,
+    kChannelIds
+};
+
+Int_t GetField(const std::string& name) {
+    static const std::map<std::string, Int_t> fields = {{"fBaseLineRange", kBaseLineRange},
+                                                        {"fIntegralRange", kIntegralRange},
+                                                        {"fPointThreshold", kPointThreshold},
+                                                        {"fSignalThreshold", kSignalThreshold},
+                                                        {"fSampling", kSampling},
+                                                        {"fNPointsOverThreshold", kNPointsOverThreshold},
+                                                        {"fNPointsFlatThreshold", kNPointsFlatThreshold},
+                                                        {"fBaseLineCorrection", kBaseLineCorrection},
+                                                        {"fChannelIds", kChannelIds}};
+    auto it = fields.find(name);
+    return it == fields.end() ? kNoField : it->second;
+}
+
+bool IsBasicType(Int_t type) {
+    switch (type) {
+        case TVirtualStreamerInfo::kChar:
+        case TVirtualStreamerInfo::kUChar:
+        case TVirtualStreamerInfo::kShort:
+        case TVirtualStreamerInfo::kUShort:
+        case TVirtualStreamerInfo::kInt:
+        case TVirtualStreamerInfo::kCounter:
+        case TVirtualStreamerInfo::kUInt:
+        case TVirtualStreamerInfo::kLong:
+        case TVirtualStreamerInfo::kULong:
+        case TVirtualStreamerInfo::kLong64:
+        case TVirtualStreamerInfo::kULong64:
+        case TVirtualStreamerInfo::kFloat:
+        case TVirtualStreamerInfo::kFloat16:
+        case TVirtualStreamerInfo::kDouble:
+        case TVirtualStreamerInfo::kDouble32:
+        case TVirtualStreamerInfo::kBool:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// It reads a basic type from the buffer, converted to Double_t
+Double_t ReadBasic(TBuffer& buffer, Int_t type, TStreamerElement* element) {
+    switch (type) {
+        case TVirtualStreamerInfo::kChar: {
+            Char_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kUChar: {
+            UChar_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kShort: {
+            Short_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kUShort: {
+            UShort_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kInt:
+        case TVirtualStreamerInfo::kCounter: {
+            Int_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kUInt: {
+            UInt_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kLong: {
+            Long_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kULong: {
+            ULong_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kLong64: {
+            Long64_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kULong64: {
+            ULong64_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kFloat: {
+            Float_t value;
+            buffer >> value;
+            return value;
+        }
+        case TVirtualStreamerInfo::kFloat16: {
+            Float_t value;
+            buffer.ReadFloat16(&value, element);
+            return value;
+        }
+        case TVirtualStreamerInfo::kDouble32: {
+            Double_t value;
+            buffer.ReadDouble32(&value, element);
+            return value;
+        }
+        case TVirtualStreamerInfo::kBool: {
+            Bool_t value;
+            buffer >> value;
+            return value;
+        }
+        default: {  // kDouble
+            Double_t value;
+            buffer >> value;
+            return value;
+        }
+    }
+}
+
+void SetField(TRestLegacyCatalog::Record& record, Int_t field, Double_t value) {
+    switch (field) {
+        case kPointThreshold:
+            record.fPointThreshold = value;
+            break;
+        case kSignalThreshold:
+            record.fSignalThreshold = value;
+            break;
+        case kSampling:
+            record.fSampling = value;
+            break;
+        case kNPointsOverThreshold:
+            record.fNPointsOverThreshold = (Int_t)value;
+            break;
+        case kNPointsFlatThreshold:
+            record.fNPointsFlatThreshold = (Int_t)value;
+            break;
+        case kBaseLineCorrection:
+            record.fBaseLineCorrection = (Int_t)value;
+            break;
+    }
+}
+
+/// It skips an object written with byte count. It returns false if there is no byte count.
+bool SkipCounted(TBuffer& buffer) {
+    UInt_t start, count;
+    buffer.ReadVersion(&start, &count);
+    if (count == 0) return false;
+    buffer.SetBufferOffset(start + count + sizeof(UInt_t));
+    return true;
+}
+
+/// It skips the TObject part of an object, as written by TObject::Streamer
+void SkipTObject(TBuffer& buffer) {
+    buffer.SkipVersion();
+    UInt_t uniqueID, bits;
+    buffer >> uniqueID;
+    buffer >> bits;
+    if (bits & kIsReferenced) {
+        UShort_t pidf;
+        buffer >> pidf;
+    }
+}
+}  // namespace
+
+///////////////////////////////////////////////
+/// \brief It returns the decoding steps of the given class version, or nullptr if the class
+/// version cannot be decoded.
+///
+const std::vector<TRestLegacyStreamer::Step>* TRestLegacyStreamer::GetPlan(const std::string& className,
+                                                                           Int_t version) {
+    auto id = std::make_pair(className, version);
+    auto it = fPlans.find(id);
+    if (it == fPlans.end()) {
+        std::vector<Step> plan;
+        TClass* cl = TClass::GetClass(className.c_str());
+        TVirtualStreamerInfo* info = cl ? cl->GetStreamerInfo(version) : nullptr;
+        if (info == nullptr || info->GetClassVersion() != version) {
+            plan.push_back({kUnsupported, kNoField, nullptr});
+        } else {
+            TIter next(info->GetElements());
+            while (TStreamerElement* element = (TStreamerElement*)next()) {
+                Int_t type = element->GetType();
+                Step step = {kUnsupported, GetField(element->GetName()), element};
+                TClass* elementClass = element->GetClassPointer();
+
+                if (IsBasicType(type))
+                    step.fKind = kBasic;
+                else if (type == TVirtualStreamerInfo::kTObject ||
+                         (type == TVirtualStreamerInfo::kBase && elementClass == TObject::Class()))
+                    step.fKind = kSkipTObject;
+                else if (type == TVirtualStreamerInfo::kTString)
+                    step.fKind = kSkipTString;
+                else if (type == TVirtualStreamerInfo::kObject && elementClass == TVector2::Class())
+                    step.fKind = kVector2;
+                else if (type == TVirtualStreamerInfo::kSTL && step.fField == kChannelIds)
+                    step.fKind = kIntVector;
+                else if (type == TVirtualStreamerInfo::kBase || type == TVirtualStreamerInfo::kObject ||
+                         type == TVirtualStreamerInfo::kAny || type == TVirtualStreamerInfo::kTNamed ||
+                         type == TVirtualStreamerInfo::kSTL)
+                    step.fKind = kSkipCounted;
+
+                plan.push_back(step);
+            }
+        }
+        it = fPlans.emplace(id, plan).first;
+    }
+
+    for (const auto& step : it->second)
+        if (step.fKind == kUnsupported) return nullptr;
+    return &it->second;
+}
+
+///////////////////////////////////////////////
+/// \brief It reads the key buffer and uncompresses it into fObjectBuffer, keeping the key header
+///
+bool TRestLegacyStreamer::ReadKeyBuffer(TFile* file, TKey* key) {
+    const Int_t nBytes = key->GetNbytes();
+    const Int_t keyLength = key->GetKeylen();
+    const Int_t objectLength = key->GetObjlen();
+    if (nBytes <= keyLength || objectLength <= 0) return false;
+
+    if ((Int_t)fKeyBuffer.size() < nBytes) fKeyBuffer.resize(nBytes);
+    if ((Int_t)fObjectBuffer.size() < keyLength + objectLength)
+        fObjectBuffer.resize(keyLength + objectLength);
+    if (file->ReadBuffer(fKeyBuffer.data(), key->GetSeekKey(), nBytes)) return false;
+
+    memcpy(fObjectBuffer.data(), fKeyBuffer.data(), keyLength);
+    if (objectLength <= nBytes - keyLength) {
+        memcpy(fObjectBuffer.data() + keyLength, fKeyBuffer.data() + keyLength, objectLength);
+        return true;
+    }
+
+    // Compressed object, possibly in several blocks
+    UChar_t* source = reinterpret_cast<UChar_t*>(fKeyBuffer.data()) + keyLength;
+    UChar_t* sourceEnd = reinterpret_cast<UChar_t*>(fKeyBuffer.data()) + nBytes;
+    UChar_t* target = reinterpret_cast<UChar_t*>(fObjectBuffer.data()) + keyLength;
+    Int_t nUncompressed = 0;
+    while (nUncompressed < objectLength && source < sourceEnd) {
+        Int_t sourceSize, targetSize, nOut = 0;
+        if (R__unzip_header(&sourceSize, source, &targetSize) != 0) return false;
+        if (source + sourceSize > sourceEnd || nUncompressed + targetSize > objectLength) return false;
+        R__unzip(&sourceSize, source, &targetSize, target + nUncompressed, &nOut);
+        if (nOut == 0) return false;
+        nUncompressed += nOut;
+        source += sourceSize;
+    }
+    return nUncompressed == objectLength;
+}
+
+bool TRestLegacyStreamer::Execute(TBuffer& buffer, const std::vector<Step>& plan,
+                                  TRestLegacyCatalog::Record& record, std::vector<Int_t>& channels) {
+    for (const auto& step : plan) {
+        switch (step.fKind) {
+            case kBasic:
+                SetField(record, step.fField, ReadBasic(buffer, step.fElement->GetType(), step.fElement));
+                break;
+            case kSkipTObject:
+                SkipTObject(buffer);
+                break;
+            case kSkipTString: {
+                UChar_t shortLength;
+                Int_t length;
+                buffer >> shortLength;
+                if (shortLength == 255)
+                    buffer >> length;
+                else
+                    length = shortLength;
+                buffer.SetBufferOffset(buffer.Length() + length);
+                break;
+            }
+            case kSkipCounted:
+                if (!SkipCounted(buffer)) return false;
+                break;
+            case kVector2: {
+                UInt_t start, count;
+                Version_t version = buffer.ReadVersion(&start, &count);
+                if (count == 0) return false;
+                // Only TVector2 version 2 was written without its TObject part
+                if (version != 2) SkipTObject(buffer);
+                Double_t x, y;
+                buffer >> x;
+                buffer >> y;
+                if (step.fField == kBaseLineRange) {
+                    record.fBaseLineRange[0] = x;
+                    record.fBaseLineRange[1] = y;
+                } else if (step.fField == kIntegralRange) {
+                    record.fIntegralRange[0] = x;
+                    record.fIntegralRange[1] = y;
+                }
+                buffer.SetBufferOffset(start + count + sizeof(UInt_t));
+                break;
+            }
+            case kIntVector: {
+                UInt_t start, count;
+                buffer.ReadVersion(&start, &count);
+                if (count == 0) return false;
+                Int_t size;
+                buffer >> size;
+                if (size < 0 || buffer.Length() + size * sizeof(Int_t) != start + count + sizeof(UInt_t))
+                    return false;
+                size_t offset = channels.size();
+                channels.resize(offset + size);
+                buffer.ReadFastArray(channels.data() + offset, size);
+                record.fNChannels += size;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It decodes the legacy object stored at `key` into `record`.
+///
+/// Recovered channel ids are appended to `channels`, and their number is added to
+/// record.fNChannels. The record name and offsets are not modified. It returns false if the
+/// object could not be decoded, in which case `channels` is left unchanged.
+///
+bool TRestLegacyStreamer::Decode(TFile* file, TKey* key, TRestLegacyCatalog::Record& record,
+                                 std::vector<Int_t>& channels) {
+    std::string className = key->GetClassName();
+    if (className == "TRestRawZeroSuppresionProcess")
+        record.fClass = TRestLegacyCatalog::kZeroSuppression;
+    else if (className == "TRestRawSignalRecoverChannelsProcess")
+        record.fClass = TRestLegacyCatalog::kRecoverChannels;
+    else
+        return false;
+
+    if (!ReadKeyBuffer(file, key)) return false;
+
+    const Int_t keyLength = key->GetKeylen();
+    TBufferFile buffer(TBuffer::kRead, keyLength + key->GetObjlen(), fObjectBuffer.data(), kFALSE);
+    buffer.SetBufferOffset(keyLength);
+
+    UInt_t start, count;
+    Version_t version = buffer.ReadVersion(&start, &count);
+    if (count == 0) return false;
+
+    const std::vector<Step>* plan = GetPlan(className, version);
+    if (plan == nullptr) return false;
+
+    size_t nChannels = channels.size();
+    Int_t nRecordChannels = record.fNChannels;
+    bool decoded = Execute(buffer, *plan, record, channels);
+    if (!decoded || (UInt_t)buffer.Length() != start + count + sizeof(UInt_t)) {
+        channels.resize(nChannels);
+        record.fNChannels = nRecordChannels;
+        return false;
+    }
+    return true;
+}
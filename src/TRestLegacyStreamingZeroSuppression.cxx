@@ -0,0 +1,308 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyStreamingZeroSuppression applies the legacy zero suppression
+/// algorithm, described at TRestLegacyZeroSuppression, to a raw signal
+/// received in consecutive chunks of any size. It is meant for very long
+/// traces, such as those of continuous readout, which do not need to be
+/// kept in memory: each accepted pulse is given to a callback as soon as
+/// it ends.
+///
+/// \code
+///     auto store = [&](Long64_t first, const Short_t* values, Int_t n) {
+///         pulses.emplace_back(first, std::vector<Short_t>(values, values + n));
+///     };
+///     TRestLegacyStreamingZeroSuppression zs(parameters, store);
+///     while (Int_t n = ReadChunk(buffer, chunkSize)) zs.Process(buffer, n);
+///     zs.Finish();
+/// \endcode
+///
+/// Two baseline modes are available:
+/// * BaseLineMode::kFixedRange (default) computes the baseline over the
+/// baseline range, as the legacy algorithm. The samples of the integral
+/// range received before the end of the baseline range are kept until the
+/// baseline is known. The accepted pulses are exactly the same as those
+/// given by TRestLegacyZeroSuppression::Suppress on the whole signal.
+/// * BaseLineMode::kSlidingWindow computes the baseline over the last
+/// `windowSize` samples not belonging to a pulse, following slow baseline
+/// drifts along the trace. No pulse is searched before the window is full.
+/// The baseline of a pulse is frozen at the first point of the pulse. Once
+/// the window is full, samples over threshold never enter it, including the
+/// sample ending a pulse through the flat points rule, so that pulses do not
+/// bias the baseline.
+///
+/// The baseline is calculated from integer sums of the ADC values, which
+/// are exact and are updated in constant time for each sample. Between
+/// chunks, only those sums, the state of the pulse in progress (its sums,
+/// the previous value and the number of consecutive flat points) and the
+/// ADC values of the pulse itself are kept. Therefore, the memory needed
+/// is bounded by the baseline range (or window) and the maximum pulse
+/// length, whatever the length of the trace.
+///
+/// A pulse reaching the maximum pulse length ends there, as if the next
+/// sample were under threshold, so that a noisy or stuck channel cannot make
+/// the pulse buffer grow without limit. By default it is the length of the
+/// integral range, the longest pulse the legacy algorithm can give, so the
+/// limit never changes the pulses found in traces of that length. For
+/// continuous readout, with a very large integral range, it should be set
+/// with SetMaxPulseLength.
+///
+/// As for the legacy process, bins are counted from the beginning of the
+/// signal and only the bins inside the integral range are searched for
+/// pulses. Finish must be called after the last chunk, to end the pulse in
+/// progress, and Reset before a new signal is processed.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyStreamingZeroSuppression.
+///
+/// \class      TRestLegacyStreamingZeroSuppression
+///
+/// <hr>
+///
+
+#include "TRestLegacyStreamingZeroSuppression.h"
+
+#include <algorithm>
+#include <cmath>
+
+TRestLegacyStreamingZeroSuppression::TRestLegacyStreamingZeroSuppression(
+    const TRestLegacyZeroSuppression::Parameters& parameters, Callback callback, BaseLineMode mode,
+    Int_t windowSize, TRestLegacyZeroSuppression::Kernel kernel)
+    : fParameters(parameters), fKernel(kernel), fMode(mode), fCallback(std::move(callback)) {
+    SetMaxPulseLength(parameters.fIntegralEnd - parameters.fIntegralStart);
+    if (fMode == BaseLineMode::kSlidingWindow) fWindow.resize(std::max(windowSize, 1));
+    Reset();
+}
+
+///////////////////////////////////////////////
+/// \brief It prepares the object to process a new signal
+///
+void TRestLegacyStreamingZeroSuppression::Reset() {
+    fNSamples = 0;
+    fBaseLineSum = 0;
+    fBaseLineSumSquares = 0;
+    fNBaseLine = 0;
+    fBaseLineReady = false;
+    fBaseLine = TRestLegacyZeroSuppression::BaseLine();
+    fThreshold = 0;
+    fSignalThreshold = 0;
+    fPending.clear();
+    fPendingFirst = 0;
+    fWindowSize = 0;
+    fWindowPosition = 0;
+    fInPulse = false;
+    fPulse.clear();
+}
+
+///////////////////////////////////////////////
+/// \brief It sets the maximum number of samples of a pulse, which is at least 1
+///
+void TRestLegacyStreamingZeroSuppression::SetMaxPulseLength(Int_t maxPulseLength) {
+    fMaxPulseLength = std::max(maxPulseLength, 1);
+}
+
+///////////////////////////////////////////////
+/// \brief It processes the next `nSamples` samples of the signal
+///
+void TRestLegacyStreamingZeroSuppression::Process(const Short_t* data, Int_t nSamples) {
+    if (nSamples <= 0) return;
+    Long64_t first = fNSamples;
+    fNSamples += nSamples;
+
+    if (fMode == BaseLineMode::kSlidingWindow) {
+        ScanSliding(data, first, nSamples);
+        return;
+    }
+    if (fBaseLineReady) {
+        ScanFixed(data, first, nSamples);
+        return;
+    }
+
+    // Samples before the end of the baseline range
+    const Long64_t baseLineEnd = fParameters.fBaseLineEnd;
+    Int_t split = (Int_t)std::min<Long64_t>(nSamples, std::max<Long64_t>(baseLineEnd - first, 0));
+
+    for (Long64_t i = std::max<Long64_t>(fParameters.fBaseLineStart, first); i < first + split; i++) {
+        Short_t adc = data[i - first];
+        fBaseLineSum += adc;
+        fBaseLineSumSquares += (Long64_t)adc * adc;
+        fNBaseLine++;
+    }
+
+    Long64_t pendingFrom = std::max<Long64_t>(fParameters.fIntegralStart, first);
+    Long64_t pendingTo = std::min<Long64_t>(fParameters.fIntegralEnd, first + split);
+    if (pendingFrom < pendingTo) {
+        if (fPending.empty()) fPendingFirst = pendingFrom;
+        fPending.insert(fPending.end(), data + (pendingFrom - first), data + (pendingTo - first));
+    }
+
+    if (first + nSamples < baseLineEnd) return;
+
+    SetThresholds();
+    if (!fPending.empty()) ScanFixed(fPending.data(), fPendingFirst, fPending.size());
+    fPending.clear();
+    if (split < nSamples) ScanFixed(data + split, first + split, nSamples - split);
+}
+
+///////////////////////////////////////////////
+/// \brief It ends the signal, giving the pulse in progress to the callback if it is accepted
+///
+/// If the signal ended before the end of the baseline range, the baseline is calculated with
+/// the samples received, as the legacy algorithm does for short signals.
+///
+void TRestLegacyStreamingZeroSuppression::Finish() {
+    if (fMode == BaseLineMode::kFixedRange && !fBaseLineReady) {
+        SetThresholds();
+        if (!fPending.empty()) ScanFixed(fPending.data(), fPendingFirst, fPending.size());
+        fPending.clear();
+    }
+    if (fInPulse) EndPulse();
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the number of bytes currently used to keep samples between chunks
+///
+size_t TRestLegacyStreamingZeroSuppression::GetMemoryUsage() const {
+    return (fPending.capacity() + fWindow.capacity() + fPulse.capacity()) * sizeof(Short_t);
+}
+
+void TRestLegacyStreamingZeroSuppression::SetThresholds() {
+    fBaseLine = TRestLegacyZeroSuppression::GetBaseLine(fBaseLineSum, fBaseLineSumSquares, fNBaseLine);
+    fThreshold = fParameters.fPointThreshold * fBaseLine.fSigma;
+    fSignalThreshold = fParameters.fSignalThreshold * fBaseLine.fSigma;
+    fBaseLineReady = true;
+}
+
+void TRestLegacyStreamingZeroSuppression::StartPulse(Long64_t bin, Short_t adc) {
+    Double_t value = (Double_t)adc - fBaseLine.fMean;
+    fInPulse = true;
+    fPulseFirst = bin;
+    fPulseSum = value;
+    fPulseSumSquares = value * value;
+    fPrevious = value;
+    fNFlat = 0;
+    fPulse.assign(1, adc);
+}
+
+///////////////////////////////////////////////
+/// \brief It adds the sample to the pulse in progress, and returns false if the sample ends the pulse
+///
+bool TRestLegacyStreamingZeroSuppression::ContinuePulse(Short_t adc) {
+    Double_t value = (Double_t)adc - fBaseLine.fMean;
+    if (value <= fThreshold) return false;
+
+    if (std::abs(value - fPrevious) > fThreshold)
+        fNFlat = 0;
+    else
+        fNFlat++;
+    if (fNFlat >= fParameters.fNPointsFlatThreshold) return false;
+    if ((Int_t)fPulse.size() >= fMaxPulseLength) return false;
+
+    fPulseSum += value;
+    fPulseSumSquares += value * value;
+    fPrevious = value;
+    fPulse.push_back(adc);
+    return true;
+}
+
+void TRestLegacyStreamingZeroSuppression::EndPulse() {
+    fInPulse = false;
+    Int_t n = fPulse.size();
+    if (n < fParameters.fNPointsOverThreshold) return;
+
+    Double_t pulseMean = fPulseSum / n;
+    Double_t stdev = std::sqrt(fPulseSumSquares / n - pulseMean * pulseMean);
+    if (stdev > fSignalThreshold && fCallback) fCallback(fPulseFirst, fPulse.data(), n);
+}
+
+///////////////////////////////////////////////
+/// \brief It searches pulses in `n` samples starting at bin `first`, once the fixed baseline is known
+///
+void TRestLegacyStreamingZeroSuppression::ScanFixed(const Short_t* data, Long64_t first, Int_t n) {
+    const Long64_t end = std::min<Long64_t>(fParameters.fIntegralEnd, first + n);
+    Long64_t i = std::max<Long64_t>(fParameters.fIntegralStart, first);
+
+    while (i < end) {
+        if (!fInPulse) {
+            i = first + TRestLegacyZeroSuppression::FindPointOverThreshold(
+                            data, i - first, end - first, fBaseLine, fParameters.fPointThreshold, fKernel);
+            if (i >= end) break;
+            StartPulse(i, data[i - first]);
+        } else if (!ContinuePulse(data[i - first])) {
+            // As in the legacy implementation, the bin ending a pulse is never the start of a new pulse
+            EndPulse();
+        }
+        i++;
+    }
+
+    if (fInPulse && first + n >= fParameters.fIntegralEnd) EndPulse();
+}
+
+void TRestLegacyStreamingZeroSuppression::AddToWindow(Short_t adc) {
+    const Int_t capacity = fWindow.size();
+    if (fWindowSize == capacity) {
+        Short_t oldest = fWindow[fWindowPosition];
+        fBaseLineSum -= oldest;
+        fBaseLineSumSquares -= (Long64_t)oldest * oldest;
+    } else {
+        fWindowSize++;
+    }
+    fWindow[fWindowPosition] = adc;
+    fWindowPosition = (fWindowPosition + 1) % capacity;
+    fBaseLineSum += adc;
+    fBaseLineSumSquares += (Long64_t)adc * adc;
+    fNBaseLine = fWindowSize;
+}
+
+///////////////////////////////////////////////
+/// \brief It searches pulses in `n` samples starting at bin `first`, using the sliding window baseline
+///
+void TRestLegacyStreamingZeroSuppression::ScanSliding(const Short_t* data, Long64_t first, Int_t n) {
+    const Int_t capacity = fWindow.size();
+    for (Long64_t i = first; i < first + n; i++) {
+        Short_t adc = data[i - first];
+        bool inIntegral = i >= fParameters.fIntegralStart && i < fParameters.fIntegralEnd;
+
+        if (fInPulse) {
+            if (inIntegral && ContinuePulse(adc)) continue;
+            EndPulse();
+            // The sample ending the pulse may still be over the baseline of the pulse
+            if ((Double_t)adc - fBaseLine.fMean <= fThreshold) AddToWindow(adc);
+            continue;
+        }
+
+        if (fWindowSize == capacity) {
+            SetThresholds();
+            if ((Double_t)adc - fBaseLine.fMean > fThreshold) {
+                if (inIntegral) StartPulse(i, adc);
+                continue;
+            }
+        }
+        AddToWindow(adc);
+    }
+}
@@ -0,0 +1,205 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyTaskPool is a pool of threads executing independent tasks,
+/// used by the legacy library tools and algorithms to spread their work
+/// among the available cores.
+///
+/// Each thread owns a queue of tasks. A thread takes its own tasks in
+/// last-in first-out order, and when its queue is empty it steals the
+/// oldest task from the queue of another thread. Tasks submitted from a
+/// thread which does not belong to the pool go to an additional shared
+/// queue, from which any thread may take them.
+///
+/// ParallelFor calls `body` once for each item in [0, nItems), grouping
+/// `grain` consecutive items in a single task. The calling thread also
+/// executes tasks while it waits for the items to be finished, so that
+/// ParallelFor may be called from inside a task without blocking the pool.
+///
+/// \code
+///     std::vector<Double_t> results(signals.size());
+///     TRestLegacyTaskPool::Instance().ParallelFor(signals.size(), [&](size_t n) {
+///         results[n] = Process(signals[n]);
+///     });
+/// \endcode
+///
+/// If `body` throws an exception, the remaining items are still executed
+/// and the first exception is rethrown by ParallelFor.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyTaskPool.
+///
+/// \class      TRestLegacyTaskPool
+///
+/// <hr>
+///
+
+#include "TRestLegacyTaskPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace {
+/// The pool and the queue owned by the current thread, if it belongs to a pool
+thread_local const TRestLegacyTaskPool* gCurrentPool = nullptr;
+thread_local size_t gCurrentQueue = 0;
+}  // namespace
+
+///////////////////////////////////////////////
+/// \brief It starts `nThreads` threads, or one thread less than the hardware cores if `nThreads` is 0
+///
+/// The thread calling ParallelFor also executes tasks, so a pool with 0 threads is valid and
+/// executes everything in the calling thread.
+///
+TRestLegacyTaskPool::TRestLegacyTaskPool(Int_t nThreads) {
+    if (nThreads <= 0) nThreads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+    for (Int_t n = 0; n <= nThreads; n++) fQueues.push_back(std::make_unique<Queue>());
+    for (Int_t n = 0; n < nThreads; n++) fThreads.emplace_back(&TRestLegacyTaskPool::Work, this, n);
+}
+
+TRestLegacyTaskPool::~TRestLegacyTaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fStop = true;
+    }
+    fWakeUp.notify_all();
+    for (auto& thread : fThreads) thread.join();
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the pool shared by the whole application
+///
+TRestLegacyTaskPool& TRestLegacyTaskPool::Instance() {
+    static TRestLegacyTaskPool pool;
+    return pool;
+}
+
+size_t TRestLegacyTaskPool::GetCurrentQueue() const {
+    if (gCurrentPool == this) return gCurrentQueue;
+    return fQueues.size() - 1;
+}
+
+void TRestLegacyTaskPool::Push(std::function<void()> task) {
+    Queue& queue = *fQueues[GetCurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.fMutex);
+        queue.fTasks.push_back(std::move(task));
+    }
+    fNQueued++;
+    // Taking the lock assures that a thread checking fNQueued before it goes to sleep gets the signal
+    { std::lock_guard<std::mutex> lock(fMutex); }
+    fWakeUp.notify_one();
+}
+
+///////////////////////////////////////////////
+/// \brief It executes a single task, taken from `queue` or stolen from another queue
+///
+/// It returns false if there was no task waiting.
+///
+bool TRestLegacyTaskPool::RunOne(size_t queue) {
+    if (fNQueued == 0) return false;
+
+    std::function<void()> task;
+    for (size_t n = 0; n < fQueues.size() && !task; n++) {
+        Queue& candidate = *fQueues[(queue + n) % fQueues.size()];
+        std::lock_guard<std::mutex> lock(candidate.fMutex);
+        if (candidate.fTasks.empty()) continue;
+        if (n == 0) {
+            task = std::move(candidate.fTasks.back());
+            candidate.fTasks.pop_back();
+        } else {
+            task = std::move(candidate.fTasks.front());
+            candidate.fTasks.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    fNQueued--;
+    task();
+    return true;
+}
+
+void TRestLegacyTaskPool::Work(size_t queue) {
+    gCurrentPool = this;
+    gCurrentQueue = queue;
+    while (true) {
+        if (RunOne(queue)) continue;
+        std::unique_lock<std::mutex> lock(fMutex);
+        fWakeUp.wait(lock, [this]() { return fStop || fNQueued > 0; });
+        if (fStop && fNQueued == 0) return;
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It calls `body(n)` for every n in [0, nItems), in parallel, and returns when all are finished
+///
+/// Consecutive items are grouped by `grain` in a single task, to reduce the scheduling cost of
+/// very short bodies. The order in which items are executed is not defined, so `body` should
+/// write its results to a place given by the item index.
+///
+void TRestLegacyTaskPool::ParallelFor(size_t nItems, const std::function<void(size_t)>& body, size_t grain) {
+    if (nItems == 0) return;
+    if (grain == 0) grain = 1;
+
+    size_t nTasks = (nItems + grain - 1) / grain;
+    if (nTasks == 1 || fThreads.empty()) {
+        for (size_t n = 0; n < nItems; n++) body(n);
+        return;
+    }
+
+    std::atomic<size_t> remaining(nTasks);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    // Tasks are pushed in reverse order, so that the owner of the queue starts by the first items
+    for (size_t t = nTasks; t-- > 0;) {
+        Push([&, t]() {
+            try {
+                for (size_t n = t * grain; n < std::min(nItems, (t + 1) * grain); n++) body(n);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+            if (--remaining == 0) {
+                { std::lock_guard<std::mutex> lock(fMutex); }
+                fFinished.notify_all();
+            }
+        });
+    }
+
+    size_t queue = GetCurrentQueue();
+    while (remaining > 0) {
+        if (RunOne(queue)) continue;
+        // Every task of this call has been taken by other threads, they only need to finish
+        std::unique_lock<std::mutex> lock(fMutex);
+        fFinished.wait(lock, [&remaining]() { return remaining == 0; });
+    }
+
+    if (error) std::rethrow_exception(error);
+}
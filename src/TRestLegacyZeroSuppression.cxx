@@ -0,0 +1,389 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyZeroSuppression implements the zero suppression algorithm
+/// described at TRestRawZeroSuppresionProcess directly on raw ADC data,
+/// so that archived raw data can be suppressed again using the legacy
+/// parameters.
+///
+/// The algorithm, for each raw signal, is as follows:
+/// * The baseline mean and sigma (the RMS around the mean) are calculated
+/// using the bins inside the baseline range.
+/// * Inside the integral range, a point is over threshold when its value,
+/// with the baseline subtracted, is above `pointThreshold` times the
+/// baseline sigma.
+/// * Consecutive points over threshold are grouped into a pulse. A pulse is
+/// artificially ended after `pointsFlatThreshold` consecutive points whose
+/// difference with the previous point is not above the point threshold.
+/// * A pulse is accepted if it contains at least `pointsOverThreshold`
+/// points and its standard deviation is above `signalThreshold` times the
+/// baseline sigma.
+///
+/// The indices of the points belonging to accepted pulses are returned.
+///
+/// Three implementations are available: a scalar reference, SSE2 and AVX2.
+/// GetBestKernel is used by default to select at runtime the best kernel
+/// supported by the CPU. The vectorized kernels only accelerate the
+/// baseline calculation, which is done with exact integer arithmetic, and
+/// the search for the next point over threshold, which is done comparing
+/// the raw ADC values against the smallest ADC value fulfilling the scalar
+/// threshold condition. Therefore, all kernels produce bit-identical
+/// results, and the scalar kernel may be used as reference.
+///
+/// \code
+///     TRestLegacyZeroSuppression::Parameters parameters = zsProcess->GetZeroSuppressionParameters();
+///     std::vector<Int_t> points;
+///     TRestLegacyZeroSuppression::Suppress(data, nBins, parameters, points);
+/// \endcode
+///
+/// TRestLegacyStreamingZeroSuppression applies the same algorithm to very
+/// long signals received in consecutive chunks.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyZeroSuppression.
+///
+/// \class      TRestLegacyZeroSuppression
+///
+/// <hr>
+///
+
+#include "TRestLegacyZeroSuppression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define REST_LEGACY_ZS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/// Integer sums over the baseline range. They are exact, whatever the order of summation.
+struct BaseLineSums {
+    Long64_t fSum = 0;
+    Long64_t fSumSquares = 0;
+};
+
+BaseLineSums SumScalar(const Short_t* data, Int_t start, Int_t end) {
+    BaseLineSums sums;
+    for (Int_t i = start; i < end; i++) {
+        sums.fSum += data[i];
+        sums.fSumSquares += (Long64_t)data[i] * data[i];
+    }
+    return sums;
+}
+
+/// It returns the first bin in [from, to) whose value, with the baseline subtracted, is over threshold
+Int_t FindOverThresholdScalar(const Short_t* data, Int_t from, Int_t to, Double_t mean, Double_t threshold) {
+    for (Int_t i = from; i < to; i++)
+        if ((Double_t)data[i] - mean > threshold) return i;
+    return to;
+}
+
+#ifdef REST_LEGACY_ZS_X86
+BaseLineSums SumSSE(const Short_t* data, Int_t start, Int_t end) {
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    __m128i sumSquares = zero;
+
+    Int_t i = start;
+    for (; i + 8 <= end; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Pairwise sums fit in Int_t, sign-extended to 64 bits before accumulation
+        __m128i pairs = _mm_madd_epi16(x, ones);
+        __m128i sign = _mm_srai_epi32(pairs, 31);
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(pairs, sign));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(pairs, sign));
+        // Pairwise sums of squares are in [0, 2^31], so they are zero-extended
+        __m128i squares = _mm_madd_epi16(x, x);
+        sumSquares = _mm_add_epi64(sumSquares, _mm_unpacklo_epi32(squares, zero));
+        sumSquares = _mm_add_epi64(sumSquares, _mm_unpackhi_epi32(squares, zero));
+    }
+
+    alignas(16) Long64_t lanes[2];
+    BaseLineSums sums = SumScalar(data, i, end);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+    sums.fSum += lanes[0] + lanes[1];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sumSquares);
+    sums.fSumSquares += lanes[0] + lanes[1];
+    return sums;
+}
+
+Int_t FindADCOverSSE(const Short_t* data, Int_t from, Int_t to, Int_t minimumADC) {
+    if (minimumADC > std::numeric_limits<Short_t>::max()) return to;
+    if (minimumADC <= std::numeric_limits<Short_t>::min()) return from < to ? from : to;
+
+    const __m128i cut = _mm_set1_epi16((Short_t)(minimumADC - 1));
+    Int_t i = from;
+    for (; i + 8 <= to; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        Int_t mask = _mm_movemask_epi8(_mm_cmpgt_epi16(x, cut));
+        if (mask != 0) return i + __builtin_ctz(mask) / 2;
+    }
+    for (; i < to; i++)
+        if (data[i] >= minimumADC) return i;
+    return to;
+}
+
+__attribute__((target("avx2"))) BaseLineSums SumAVX2(const Short_t* data, Int_t start, Int_t end) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum = zero;
+    __m256i sumSquares = zero;
+
+    Int_t i = start;
+    for (; i + 16 <= end; i += 16) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i pairs = _mm256_madd_epi16(x, ones);
+        __m256i sign = _mm256_srai_epi32(pairs, 31);
+        sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(pairs, sign));
+        sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi32(pairs, sign));
+        __m256i squares = _mm256_madd_epi16(x, x);
+        sumSquares = _mm256_add_epi64(sumSquares, _mm256_unpacklo_epi32(squares, zero));
+        sumSquares = _mm256_add_epi64(sumSquares, _mm256_unpackhi_epi32(squares, zero));
+    }
+
+    alignas(32) Long64_t lanes[4];
+    BaseLineSums sums = SumSSE(data, i, end);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+    sums.fSum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sumSquares);
+    sums.fSumSquares += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return sums;
+}
+
+__attribute__((target("avx2"))) Int_t FindADCOverAVX2(const Short_t* data, Int_t from, Int_t to,
+                                                      Int_t minimumADC) {
+    if (minimumADC > std::numeric_limits<Short_t>::max()) return to;
+    if (minimumADC <= std::numeric_limits<Short_t>::min()) return from < to ? from : to;
+
+    const __m256i cut = _mm256_set1_epi16((Short_t)(minimumADC - 1));
+    Int_t i = from;
+    for (; i + 16 <= to; i += 16) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        UInt_t mask = (UInt_t)_mm256_movemask_epi8(_mm256_cmpgt_epi16(x, cut));
+        if (mask != 0) return i + __builtin_ctz(mask) / 2;
+    }
+    return FindADCOverSSE(data, i, to, minimumADC);
+}
+#endif
+
+BaseLineSums Sum(const Short_t* data, Int_t start, Int_t end, TRestLegacyZeroSuppression::Kernel kernel) {
+#ifdef REST_LEGACY_ZS_X86
+    if (kernel == TRestLegacyZeroSuppression::Kernel::kAVX2) return SumAVX2(data, start, end);
+    if (kernel == TRestLegacyZeroSuppression::Kernel::kSSE) return SumSSE(data, start, end);
+#endif
+    return SumScalar(data, start, end);
+}
+
+Int_t FindOverThreshold(const Short_t* data, Int_t from, Int_t to, Double_t mean, Double_t threshold,
+                        Int_t minimumADC, TRestLegacyZeroSuppression::Kernel kernel) {
+#ifdef REST_LEGACY_ZS_X86
+    if (kernel == TRestLegacyZeroSuppression::Kernel::kAVX2)
+        return FindADCOverAVX2(data, from, to, minimumADC);
+    if (kernel == TRestLegacyZeroSuppression::Kernel::kSSE) return FindADCOverSSE(data, from, to, minimumADC);
+#endif
+    return FindOverThresholdScalar(data, from, to, mean, threshold);
+}
+}  // namespace
+
+///////////////////////////////////////////////
+/// \brief It returns the fastest kernel supported by the running CPU
+///
+TRestLegacyZeroSuppression::Kernel TRestLegacyZeroSuppression::GetBestKernel() {
+    static const Kernel best = IsKernelSupported(Kernel::kAVX2)  ? Kernel::kAVX2
+                               : IsKernelSupported(Kernel::kSSE) ? Kernel::kSSE
+                                                                 : Kernel::kScalar;
+    return best;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns true if the kernel can be executed in the running CPU
+///
+bool TRestLegacyZeroSuppression::IsKernelSupported(Kernel kernel) {
+    if (kernel == Kernel::kScalar) return true;
+#ifdef REST_LEGACY_ZS_X86
+    if (kernel == Kernel::kSSE) return __builtin_cpu_supports("sse2");
+    if (kernel == Kernel::kAVX2) return __builtin_cpu_supports("avx2");
+#endif
+    return false;
+}
+
+std::string TRestLegacyZeroSuppression::GetKernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::kSSE:
+            return "sse2";
+        case Kernel::kAVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the baseline mean and sigma given the sums of `n` ADC values and of their squares
+///
+TRestLegacyZeroSuppression::BaseLine TRestLegacyZeroSuppression::GetBaseLine(Long64_t sum,
+                                                                             Long64_t sumSquares, Int_t n) {
+    BaseLine baseLine;
+    if (n <= 0) return baseLine;
+
+    baseLine.fMean = (Double_t)sum / n;
+    Double_t variance = (Double_t)sumSquares / n - baseLine.fMean * baseLine.fMean;
+    baseLine.fSigma = std::sqrt(std::max(variance, 0.0));
+    return baseLine;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the smallest ADC value whose value, with `mean` subtracted, is above `threshold`
+///
+/// Since the condition is monotonic on the ADC value, comparing the raw values against it is exact.
+/// A value above the Short_t range means no ADC value fulfills the condition.
+///
+Int_t TRestLegacyZeroSuppression::GetMinimumADCOverThreshold(Double_t mean, Double_t threshold) {
+    const Int_t lowest = std::numeric_limits<Short_t>::min();
+    const Int_t highest = std::numeric_limits<Short_t>::max();
+    auto isOver = [&](Int_t adc) { return (Double_t)adc - mean > threshold; };
+
+    Double_t guess = std::ceil(mean + threshold);
+    Int_t adc = std::isfinite(guess) ? (Int_t)std::max<Double_t>(lowest, std::min<Double_t>(highest, guess))
+                                     : highest;
+    while (adc > lowest && isOver(adc - 1)) adc--;
+    while (adc <= highest && !isOver(adc)) adc++;
+    return adc;
+}
+
+///////////////////////////////////////////////
+/// \brief It calculates the baseline mean and sigma using the bins in the range [start, end)
+///
+/// The range is clamped to the signal length. A kernel not supported by the CPU is replaced by the
+/// scalar one.
+///
+TRestLegacyZeroSuppression::BaseLine TRestLegacyZeroSuppression::ComputeBaseLine(const Short_t* data,
+                                                                                 Int_t nBins, Int_t start,
+                                                                                 Int_t end, Kernel kernel) {
+    start = std::max(start, 0);
+    end = std::min(end, nBins);
+
+    if (end <= start) return BaseLine();
+    if (!IsKernelSupported(kernel)) kernel = Kernel::kScalar;
+
+    BaseLineSums sums = Sum(data, start, end, kernel);
+    return GetBaseLine(sums.fSum, sums.fSumSquares, end - start);
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the first bin in [from, to) over threshold, or `to` if there is none
+///
+/// A bin is over threshold when its value, with the baseline mean subtracted, is above
+/// `pointThreshold` times the baseline sigma.
+///
+Int_t TRestLegacyZeroSuppression::FindPointOverThreshold(const Short_t* data, Int_t from, Int_t to,
+                                                         const BaseLine& baseLine, Double_t pointThreshold,
+                                                         Kernel kernel) {
+    if (!IsKernelSupported(kernel)) kernel = Kernel::kScalar;
+    const Double_t threshold = pointThreshold * baseLine.fSigma;
+    return FindOverThreshold(data, from, to, baseLine.fMean, threshold,
+                             GetMinimumADCOverThreshold(baseLine.fMean, threshold), kernel);
+}
+
+///////////////////////////////////////////////
+/// \brief It fills `points` with the bins belonging to accepted pulses, following the legacy algorithm
+///
+/// The given baseline is subtracted from the data. Previous contents of `points` are removed.
+///
+void TRestLegacyZeroSuppression::GetPointsOverThreshold(const Short_t* data, Int_t nBins,
+                                                        const Parameters& parameters,
+                                                        const BaseLine& baseLine, std::vector<Int_t>& points,
+                                                        Kernel kernel) {
+    points.clear();
+    if (!IsKernelSupported(kernel)) kernel = Kernel::kScalar;
+
+    const Int_t start = std::max(parameters.fIntegralStart, 0);
+    const Int_t end = std::min(parameters.fIntegralEnd, nBins);
+    const Double_t mean = baseLine.fMean;
+    const Double_t threshold = parameters.fPointThreshold * baseLine.fSigma;
+    const Double_t signalThreshold = parameters.fSignalThreshold * baseLine.fSigma;
+    const Int_t minimumADC = GetMinimumADCOverThreshold(mean, threshold);
+
+    auto value = [&](Int_t bin) { return (Double_t)data[bin] - mean; };
+
+    Int_t i = start;
+    while (i < end) {
+        i = FindOverThreshold(data, i, end, mean, threshold, minimumADC, kernel);
+        if (i >= end) break;
+
+        Int_t pos = i;
+        Double_t sum = value(i);
+        Double_t sumSquares = value(i) * value(i);
+        i++;
+
+        Int_t flatN = 0;
+        while (i < end && value(i) > threshold) {
+            if (std::abs(value(i) - value(i - 1)) > threshold)
+                flatN = 0;
+            else
+                flatN++;
+
+            if (flatN >= parameters.fNPointsFlatThreshold) break;
+
+            sum += value(i);
+            sumSquares += value(i) * value(i);
+            i++;
+        }
+
+        Int_t n = i - pos;
+        if (n >= parameters.fNPointsOverThreshold) {
+            Double_t pulseMean = sum / n;
+            Double_t stdev = std::sqrt(sumSquares / n - pulseMean * pulseMean);
+            if (stdev > signalThreshold)
+                for (Int_t j = pos; j < i; j++) points.push_back(j);
+        }
+
+        // As in the legacy implementation, the bin following a pulse is never the start of a new pulse
+        i++;
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It calculates the baseline and fills `points` with the bins surviving the zero suppression.
+///
+/// It returns the calculated baseline.
+///
+TRestLegacyZeroSuppression::BaseLine TRestLegacyZeroSuppression::Suppress(const Short_t* data, Int_t nBins,
+                                                                          const Parameters& parameters,
+                                                                          std::vector<Int_t>& points,
+                                                                          Kernel kernel) {
+    BaseLine baseLine =
+        ComputeBaseLine(data, nBins, parameters.fBaseLineStart, parameters.fBaseLineEnd, kernel);
+    GetPointsOverThreshold(data, nBins, parameters, baseLine, points, kernel);
+    return baseLine;
+}
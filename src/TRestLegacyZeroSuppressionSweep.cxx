@@ -0,0 +1,184 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestLegacyZeroSuppressionSweep applies any number of legacy zero
+/// suppression configurations (see TRestLegacyZeroSuppression) to the raw
+/// data in a single pass. It allows to compare the results obtained with
+/// the parameters stored in a TRestRawZeroSuppresionProcess with new
+/// thresholds without reading the raw data once per configuration.
+///
+/// The baseline of each signal is calculated only once for each distinct
+/// baseline range, and shared by all the configurations using that range.
+///
+/// The surviving points of each configuration are written to two output
+/// branches, `<name>_signalIds` and `<name>_bins`, containing for each
+/// surviving point its signal id and its bin. All the configurations must
+/// be added before calling CreateBranches.
+///
+/// \code
+///     TRestLegacyZeroSuppressionSweep sweep;
+///     sweep.AddConfiguration("legacy", zsProcess->GetZeroSuppressionParameters());
+///     TRestLegacyZeroSuppression::Parameters tight = zsProcess->GetZeroSuppressionParameters();
+///     tight.fPointThreshold = 4;
+///     sweep.AddConfiguration("tight", tight);
+///     sweep.CreateBranches(tree);
+///
+///     // For each event
+///     sweep.ClearEvent();
+///     for (each signal) sweep.ProcessSignal(signalId, data, nBins);
+///     tree->Fill();
+/// \endcode
+///
+/// Events with many signals may be processed at once by ProcessEvent,
+/// which spreads the signals among the threads of a TRestLegacyTaskPool.
+/// Each signal writes its surviving points to its own slot, and the slots
+/// are joined in the order the signals were given. Therefore, the output
+/// is the same as calling ProcessSignal for each signal, whatever the
+/// number of threads.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October: First implementation of TRestLegacyZeroSuppressionSweep.
+///
+/// 2026-October: Signals of an event processed in parallel.
+///
+/// \class      TRestLegacyZeroSuppressionSweep
+///
+/// <hr>
+///
+
+#include "TRestLegacyZeroSuppressionSweep.h"
+
+#include <TTree.h>
+
+#include <algorithm>
+
+#include "TRestLegacyTaskPool.h"
+
+///////////////////////////////////////////////
+/// \brief It adds a new configuration and returns its index
+///
+size_t TRestLegacyZeroSuppressionSweep::AddConfiguration(
+    const std::string& name, const TRestLegacyZeroSuppression::Parameters& parameters) {
+    std::pair<Int_t, Int_t> range(parameters.fBaseLineStart, parameters.fBaseLineEnd);
+
+    size_t rangeIndex = 0;
+    while (rangeIndex < fBaseLineRanges.size() && fBaseLineRanges[rangeIndex] != range) rangeIndex++;
+    if (rangeIndex == fBaseLineRanges.size()) fBaseLineRanges.push_back(range);
+
+    fNames.push_back(name);
+    fConfigurations.push_back(parameters);
+    fBaseLineRangeIndex.push_back(rangeIndex);
+    fSignalIds.emplace_back();
+    fBins.emplace_back();
+    fBaseLines.resize(fBaseLineRanges.size());
+
+    return fConfigurations.size() - 1;
+}
+
+///////////////////////////////////////////////
+/// \brief It removes the surviving points of the previous event, for all the configurations
+///
+void TRestLegacyZeroSuppressionSweep::ClearEvent() {
+    for (auto& ids : fSignalIds) ids.clear();
+    for (auto& bins : fBins) bins.clear();
+}
+
+///////////////////////////////////////////////
+/// \brief It applies all the configurations to a raw signal
+///
+/// The surviving points are appended to the output of each configuration.
+///
+void TRestLegacyZeroSuppressionSweep::ProcessSignal(Int_t signalId, const Short_t* data, Int_t nBins) {
+    for (size_t n = 0; n < fBaseLineRanges.size(); n++)
+        fBaseLines[n] = TRestLegacyZeroSuppression::ComputeBaseLine(
+            data, nBins, fBaseLineRanges[n].first, fBaseLineRanges[n].second, fKernel);
+
+    for (size_t n = 0; n < fConfigurations.size(); n++) {
+        TRestLegacyZeroSuppression::GetPointsOverThreshold(
+            data, nBins, fConfigurations[n], fBaseLines[fBaseLineRangeIndex[n]], fPoints, fKernel);
+        fSignalIds[n].insert(fSignalIds[n].end(), fPoints.size(), signalId);
+        fBins[n].insert(fBins[n].end(), fPoints.begin(), fPoints.end());
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It applies all the configurations to all the signals of an event, in parallel
+///
+/// Signal `n` has id `signalIds[n]` and `nBins[n]` bins starting at `data[n]`. The surviving
+/// points of the previous event are removed, and the output is the same as calling ProcessSignal
+/// for each signal in order. If no pool is given, the pool shared by the application is used.
+///
+void TRestLegacyZeroSuppressionSweep::ProcessEvent(const std::vector<Int_t>& signalIds,
+                                                   const std::vector<const Short_t*>& data,
+                                                   const std::vector<Int_t>& nBins,
+                                                   TRestLegacyTaskPool* pool) {
+    ClearEvent();
+    if (pool == nullptr) pool = &TRestLegacyTaskPool::Instance();
+
+    const size_t nSignals = signalIds.size();
+    const size_t nConfigurations = fConfigurations.size();
+    if (fSignalPoints.size() < nSignals * nConfigurations) fSignalPoints.resize(nSignals * nConfigurations);
+
+    auto processSignal = [&](size_t s) {
+        thread_local std::vector<TRestLegacyZeroSuppression::BaseLine> baseLines;
+        baseLines.resize(fBaseLineRanges.size());
+        for (size_t n = 0; n < fBaseLineRanges.size(); n++)
+            baseLines[n] = TRestLegacyZeroSuppression::ComputeBaseLine(
+                data[s], nBins[s], fBaseLineRanges[n].first, fBaseLineRanges[n].second, fKernel);
+
+        for (size_t n = 0; n < nConfigurations; n++)
+            TRestLegacyZeroSuppression::GetPointsOverThreshold(
+                data[s], nBins[s], fConfigurations[n], baseLines[fBaseLineRangeIndex[n]],
+                fSignalPoints[s * nConfigurations + n], fKernel);
+    };
+
+    // A few tasks per thread, so that threads finishing early can steal work from the others
+    size_t grain = std::max<size_t>(1, nSignals / (4 * (pool->GetNumberOfThreads() + 1)));
+    pool->ParallelFor(nSignals, processSignal, grain);
+
+    for (size_t n = 0; n < nConfigurations; n++) {
+        for (size_t s = 0; s < nSignals; s++) {
+            const std::vector<Int_t>& points = fSignalPoints[s * nConfigurations + n];
+            fSignalIds[n].insert(fSignalIds[n].end(), points.size(), signalIds[s]);
+            fBins[n].insert(fBins[n].end(), points.begin(), points.end());
+        }
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It creates the output branches of every configuration in the given tree
+///
+/// No configuration may be added afterwards, since the branches keep the address of
+/// the output vectors.
+///
+void TRestLegacyZeroSuppressionSweep::CreateBranches(TTree* tree) {
+    for (size_t n = 0; n < fConfigurations.size(); n++) {
+        tree->Branch((fNames[n] + "_signalIds").c_str(), &fSignalIds[n]);
+        tree->Branch((fNames[n] + "_bins").c_str(), &fBins[n]);
+    }
+}
@@ -51,6 +51,11 @@
 /// was compiled. You may check if it is the case executing the command
 /// `rest-config --libs`, and checking the output shows `-lRestDetector`.
 ///
+/// This is a legacy class. When it is found in a processing chain, the
+/// channel ids are translated into a TRestDetectorSignalRecoveryProcess
+/// instance, which will process the events instead. See TRestLegacyProcess
+/// for details.
+///
 ///--------------------------------------------------------------------------
 ///
 /// RESTsoft - Software for Rare Event Searches with TPCs
@@ -60,6 +65,8 @@
 /// 2017-November: First implementation of TRestRawSignalRecoverChannelsProcess.
 ///             Javier Galan
 ///
+/// 2026-October: Events are forwarded to TRestDetectorSignalRecoveryProcess.
+///
 /// \class      TRestRawSignalRecoverChannelsProcess
 /// \author     Javier Galan
 ///
@@ -68,3 +75,8 @@
 #include "TRestRawSignalRecoverChannelsProcess.h"
 
 ClassImp(TRestRawSignalRecoverChannelsProcess);
+
+namespace {
+const TRestLegacyProcess::SuccessorRegistration kSuccessorRegistration("TRestRawSignalRecoverChannelsProcess",
+                                                                       "TRestDetectorSignalRecoveryProcess");
+}
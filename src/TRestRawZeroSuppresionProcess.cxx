@@ -26,6 +26,11 @@
 /// any instance to a legacy process. The information below is kept to
 /// have a reference of previous implementations.
 ///
+/// When this process is found in a processing chain, its parameters are
+/// translated into a TRestRawToDetectorSignalProcess instance with zero
+/// suppression enabled, which will process the events instead. See
+/// TRestLegacyProcess for details.
+///
 /// The TRestRawZeroSuppresionProcess identifies the points that are over
 /// threshold from the input TRestRawSignalEvent. The resulting points, that
 /// are presumed to be a physical signal, will be transported to the output
@@ -84,6 +89,8 @@
 /// process.
 ///               Javier Galan
 ///
+/// 2026-October: Events are forwarded to TRestRawToDetectorSignalProcess.
+///
 /// \class      TRestRawZeroSuppresionProcess
 /// \author     Javier Galan
 /// \author     Kaixiang Ni
@@ -94,3 +101,8 @@
 #include "TRestRawZeroSuppresionProcess.h"
 
 ClassImp(TRestRawZeroSuppresionProcess);
+
+namespace {
+const TRestLegacyProcess::SuccessorRegistration kSuccessorRegistration("TRestRawZeroSuppresionProcess",
+                                                                       "TRestRawToDetectorSignalProcess");
+}
@@ -0,0 +1,234 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Test of the columnar cache of legacy zero suppression observables.
+//
+// restLegacyObservableCacheTest
+//
+// The observables computed by the cache, for events with signals of several lengths and for alternating
+// parameter sets, must be those obtained with the scalar zero suppression kernel. The cache file must
+// survive a round trip: events added and written are found, with the same values, by a cache opening the
+// file, and events written later are merged with those already in the file, replacing the events with
+// the same key. The cache file is written to the working directory and removed at the end.
+//
+// The number of failed checks is printed and returned, so that the test fails when any check fails.
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "TRestLegacyObservableCache.h"
+
+namespace {
+
+using Cache = TRestLegacyObservableCache;
+using Parameters = TRestLegacyZeroSuppression::Parameters;
+
+const std::string kCacheFile = "restLegacyObservableCacheTest.cache";
+
+Int_t gNChecks = 0;
+Int_t gNFailures = 0;
+
+void Check(bool condition, const std::string& what) {
+    gNChecks++;
+    if (condition) return;
+    gNFailures++;
+    if (gNFailures <= 20) std::cerr << "FAILED: " << what << std::endl;
+}
+
+/// The observables of an event, computed signal by signal with the scalar kernel
+Cache::Values ReferenceObservables(const Parameters& parameters,
+                                  const std::vector<std::vector<Short_t>>& signals) {
+    Cache::Values values{};
+    std::vector<Int_t> points;
+    for (const auto& signal : signals) {
+        TRestLegacyZeroSuppression::BaseLine baseLine = TRestLegacyZeroSuppression::Suppress(
+            signal.data(), signal.size(), parameters, points, TRestLegacyZeroSuppression::Kernel::kScalar);
+        values[Cache::kBaseLineMean] += baseLine.fMean;
+        values[Cache::kBaseLineSigmaMean] += baseLine.fSigma;
+        if (points.empty()) continue;
+
+        values[Cache::kNumberOfSignals]++;
+        values[Cache::kNumberOfPoints] += points.size();
+        for (Int_t point : points) values[Cache::kIntegral] += signal[point] - baseLine.fMean;
+    }
+    if (!signals.empty()) {
+        values[Cache::kBaseLineMean] /= signals.size();
+        values[Cache::kBaseLineSigmaMean] /= signals.size();
+    }
+    return values;
+}
+
+void TestComputeObservables() {
+    std::mt19937 random(1);
+    std::normal_distribution<double> noise(250, 6);
+
+    Parameters loose;
+    loose.fPointThreshold = 3;
+    Parameters tight;
+    tight.fPointThreshold = 5;
+    tight.fNPointsOverThreshold = 3;
+
+    Cache cache;
+    for (Int_t event = 0; event < 60; event++) {
+        // Signals of the lengths with specialized kernels, and of another length
+        std::vector<std::vector<Short_t>> signals;
+        for (Int_t nBins : {512, 512, 1024, 300, 512}) {
+            std::vector<Short_t> signal(nBins);
+            for (auto& adc : signal) adc = (Short_t)noise(random);
+            Int_t first = 60 + random() % (nBins - 100);
+            for (Int_t k = 0; k < 30; k++) signal[first + k] += 10 * k;
+            signals.push_back(signal);
+        }
+        std::vector<const Short_t*> data;
+        std::vector<Int_t> nBins;
+        for (const auto& signal : signals) {
+            data.push_back(signal.data());
+            nBins.push_back(signal.size());
+        }
+
+        // The parameter set changes every few events
+        const Parameters& parameters = (event / 7) % 2 ? tight : loose;
+        Check(cache.ComputeObservables(parameters, data, nBins) == ReferenceObservables(parameters, signals),
+              "event " + std::to_string(event) + ": observables differ from the scalar kernel");
+    }
+
+    Check(cache.ComputeObservables(loose, {}, {}) == Cache::Values{},
+          "empty event: observables are not zero");
+}
+
+/// The values of an event, different for each key and version
+Cache::Values MakeValues(Int_t runId, Int_t eventId, Int_t version) {
+    Cache::Values values;
+    for (Int_t o = 0; o < Cache::kNObservables; o++)
+        values[o] = runId * 1000. + eventId + o * 0.1 + version * 0.01;
+    return values;
+}
+
+using Key = std::tuple<ULong64_t, Int_t, Int_t>;
+
+/// It checks that `cache` contains exactly the events of `expected`, with their values
+void CheckContents(const Cache& cache, const std::map<Key, Cache::Values>& expected,
+                   const std::string& what) {
+    Check(cache.GetNumberOfRows() == (Long64_t)expected.size(), what + ": wrong number of rows");
+    for (const auto& event : expected) {
+        const Key& key = event.first;
+        Long64_t row = cache.Find(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+        Check(row >= 0, what + ": event not found");
+        if (row < 0) continue;
+        bool same = true;
+        for (Int_t o = 0; o < Cache::kNObservables; o++)
+            same = same && cache.GetColumn((Cache::Observable)o)[row] == event.second[o];
+        Check(same, what + ": values differ");
+    }
+}
+
+void TestRoundTrip() {
+    remove(kCacheFile.c_str());
+
+    Parameters parameters;
+    const ULong64_t hash = Cache::GetParameterHash(parameters);
+    parameters.fPointThreshold = 3;
+    const ULong64_t otherHash = Cache::GetParameterHash(parameters);
+    Check(hash != otherHash, "different parameters give the same hash");
+
+    Cache writer;
+    Check(!writer.Open(kCacheFile), "a missing cache file was opened");
+
+    // Events added in no particular order
+    std::map<Key, Cache::Values> expected;
+    for (Int_t runId : {12, 10, 11}) {
+        for (Int_t eventId = 4; eventId >= 0; eventId--) {
+            writer.Add(runId, eventId, hash, MakeValues(runId, eventId, 0));
+            expected[Key(hash, runId, eventId)] = MakeValues(runId, eventId, 0);
+        }
+    }
+    writer.Add(11, 2, otherHash, MakeValues(11, 2, 0));
+    expected[Key(otherHash, 11, 2)] = MakeValues(11, 2, 0);
+
+    Check(writer.Write(kCacheFile), "first write failed");
+    Check(writer.GetNumberOfPendingRows() == 0, "events still pending after the first write");
+    CheckContents(writer, expected, "after the first write");
+
+    Cache reader;
+    Check(reader.Open(kCacheFile), "the cache file cannot be opened");
+    CheckContents(reader, expected, "opened after the first write");
+
+    // Events merged with an existing file: a new run, a new event and an event replaced
+    Cache merger;
+    Check(merger.Open(kCacheFile), "the cache file cannot be opened to merge");
+    for (const auto& key : {Key(hash, 13, 0), Key(hash, 10, 7), Key(hash, 11, 3)}) {
+        Cache::Values values = MakeValues(std::get<1>(key), std::get<2>(key), 1);
+        merger.Add(std::get<1>(key), std::get<2>(key), hash, values);
+        expected[key] = values;
+    }
+    Check(merger.Write(kCacheFile), "merge write failed");
+
+    Cache merged;
+    Check(merged.Open(kCacheFile), "the merged cache file cannot be opened");
+    CheckContents(merged, expected, "opened after the merge");
+
+    // Rows of a parameter set and of a run
+    auto rows = merged.GetRows(hash);
+    Check(rows.second - rows.first == (Long64_t)expected.size() - 1,
+          "wrong number of rows of the parameter set");
+    auto runRows = merged.GetRows(hash, 10);
+    Check(runRows.second - runRows.first == 6, "wrong number of rows of run 10");
+    bool sorted = true;
+    for (Long64_t row = runRows.first; row < runRows.second; row++)
+        sorted = sorted && merged.GetRunIds()[row] == 10 && merged.GetParameterHashes()[row] == hash &&
+                 (row == runRows.first || merged.GetEventIds()[row - 1] < merged.GetEventIds()[row]);
+    Check(sorted, "rows of run 10 are not contiguous and sorted");
+    Check(merged.GetRows(otherHash).second - merged.GetRows(otherHash).first == 1,
+          "wrong number of rows of the other parameter set");
+
+    Check(merged.Find(hash, 10, 5) == -1, "missing event found");
+    Check(merged.Find(otherHash, 11, 3) == -1, "event found with the wrong parameter set");
+
+    // A truncated file is rejected
+    FILE* file = fopen(kCacheFile.c_str(), "r+b");
+    if (file != nullptr) {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fclose(file);
+        Check(truncate(kCacheFile.c_str(), size - 4) == 0, "the cache file cannot be truncated");
+        Cache truncated;
+        Check(!truncated.Open(kCacheFile), "a truncated cache file was opened");
+    }
+
+    remove(kCacheFile.c_str());
+}
+}  // namespace
+
+int main() {
+    TestComputeObservables();
+    TestRoundTrip();
+
+    std::cout << gNChecks << " checks, " << gNFailures << " failed" << std::endl;
+    return gNFailures > 0 ? 1 : 0;
+}
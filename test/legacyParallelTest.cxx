@@ -0,0 +1,218 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Test of the channel-parallel zero suppression sweep and channel recovery against their serial versions.
+//
+// restLegacyParallelTest
+//
+// TRestLegacyZeroSuppressionSweep::ProcessEvent must give the same surviving points, in the same order,
+// as calling ProcessSignal for each signal. TRestLegacyChannelRecovery::ApplyParallel must give the same
+// batch, sample by sample, as Apply. Both are checked with pools of several sizes, and also from inside
+// the tasks of an outer ParallelFor on the same pool, as done when several events are processed at the
+// same time.
+//
+// The number of failed checks is printed and returned, so that the test fails when any check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TRestLegacyChannelRecovery.h"
+#include "TRestLegacyTaskPool.h"
+#include "TRestLegacyZeroSuppressionSweep.h"
+
+namespace {
+
+Int_t gNChecks = 0;
+Int_t gNFailures = 0;
+
+void Check(bool condition, const std::string& what) {
+    gNChecks++;
+    if (condition) return;
+    gNFailures++;
+    if (gNFailures <= 20) std::cerr << "FAILED: " << what << std::endl;
+}
+
+/// The raw signals of an event, with gaussian noise and a pulse in some of them
+struct Event {
+    std::vector<Int_t> fSignalIds;
+    std::vector<std::vector<Short_t>> fSignals;
+    std::vector<const Short_t*> fData;
+    std::vector<Int_t> fNBins;
+};
+
+Event GenerateEvent(std::mt19937& random, Int_t nSignals) {
+    Event event;
+    std::normal_distribution<double> noise(250, 8);
+    for (Int_t s = 0; s < nSignals; s++) {
+        // Signals of different lengths, so that the tasks have different costs
+        std::vector<Short_t> signal(256 + random() % 768);
+        for (auto& adc : signal) adc = (Short_t)std::lround(noise(random));
+        if (random() % 4 == 0) {
+            size_t first = random() % signal.size();
+            for (size_t k = 0; k < 30 && first + k < signal.size(); k++) signal[first + k] += 15 * k;
+        }
+        event.fSignalIds.push_back(3 * s + 1);
+        event.fSignals.push_back(std::move(signal));
+    }
+    for (const auto& signal : event.fSignals) {
+        event.fData.push_back(signal.data());
+        event.fNBins.push_back(signal.size());
+    }
+    return event;
+}
+
+/// A sweep with several configurations sharing some of their baseline ranges
+void AddConfigurations(TRestLegacyZeroSuppressionSweep& sweep) {
+    TRestLegacyZeroSuppression::Parameters parameters;
+    for (Double_t threshold : {2., 3., 5.}) {
+        parameters.fPointThreshold = threshold;
+        parameters.fNPointsOverThreshold = 3;
+        sweep.AddConfiguration("threshold" + std::to_string((Int_t)threshold), parameters);
+    }
+    parameters.fBaseLineStart = 200;
+    parameters.fBaseLineEnd = 250;
+    sweep.AddConfiguration("lateBaseLine", parameters);
+}
+
+/// It processes an event signal by signal, and returns the points of each configuration
+std::vector<std::pair<std::vector<Int_t>, std::vector<Int_t>>> ProcessSerial(const Event& event) {
+    TRestLegacyZeroSuppressionSweep sweep;
+    AddConfigurations(sweep);
+    sweep.ClearEvent();
+    for (size_t s = 0; s < event.fSignalIds.size(); s++)
+        sweep.ProcessSignal(event.fSignalIds[s], event.fData[s], event.fNBins[s]);
+
+    std::vector<std::pair<std::vector<Int_t>, std::vector<Int_t>>> result;
+    for (size_t n = 0; n < sweep.GetNumberOfConfigurations(); n++)
+        result.emplace_back(sweep.GetSignalIds(n), sweep.GetBins(n));
+    return result;
+}
+
+bool SamePoints(const TRestLegacyZeroSuppressionSweep& sweep,
+                const std::vector<std::pair<std::vector<Int_t>, std::vector<Int_t>>>& expected) {
+    for (size_t n = 0; n < sweep.GetNumberOfConfigurations(); n++)
+        if (sweep.GetSignalIds(n) != expected[n].first || sweep.GetBins(n) != expected[n].second)
+            return false;
+    return true;
+}
+
+void TestSweep(TRestLegacyTaskPool& pool, const std::string& what) {
+    std::mt19937 random(1);
+    std::vector<Event> events;
+    for (Int_t nSignals : {0, 1, 7, 500, 3000}) events.push_back(GenerateEvent(random, nSignals));
+
+    std::vector<std::vector<std::pair<std::vector<Int_t>, std::vector<Int_t>>>> expected;
+    for (const auto& event : events) expected.push_back(ProcessSerial(event));
+
+    // The same sweep reused for consecutive events
+    TRestLegacyZeroSuppressionSweep sweep;
+    AddConfigurations(sweep);
+    for (size_t e = 0; e < events.size(); e++) {
+        sweep.ProcessEvent(events[e].fSignalIds, events[e].fData, events[e].fNBins, &pool);
+        Check(SamePoints(sweep, expected[e]), what + " sweep event " + std::to_string(e) + ": points differ");
+    }
+
+    // Events processed at the same time, each one parallelized on the same pool
+    std::vector<std::unique_ptr<TRestLegacyZeroSuppressionSweep>> sweeps;
+    for (size_t e = 0; e < events.size(); e++) {
+        sweeps.push_back(std::make_unique<TRestLegacyZeroSuppressionSweep>());
+        AddConfigurations(*sweeps.back());
+    }
+    pool.ParallelFor(events.size(), [&](size_t e) {
+        sweeps[e]->ProcessEvent(events[e].fSignalIds, events[e].fData, events[e].fNBins, &pool);
+    });
+    for (size_t e = 0; e < events.size(); e++)
+        Check(SamePoints(*sweeps[e], expected[e]),
+              what + " nested sweep event " + std::to_string(e) + ": points differ");
+}
+
+/// A recovery table with dead channels depending on other dead channels, so that several waves are needed
+TRestLegacyChannelRecovery GenerateRecovery(std::mt19937& random, const std::vector<Int_t>& rowSignalIds) {
+    TRestLegacyChannelRecovery recovery;
+    for (Int_t n = 0; n < 60; n++) {
+        // A few ids are not in the batch, as channels missing from an event
+        Int_t target = random() % (rowSignalIds.size() + 10);
+        std::vector<Int_t> neighbours;
+        std::vector<Float_t> weights;
+        Int_t nNeighbours = 1 + random() % 4;
+        for (Int_t m = 0; m < nNeighbours; m++) {
+            neighbours.push_back(random() % (rowSignalIds.size() + 10));
+            weights.push_back(0.1 + (random() % 10) / 10.);
+        }
+        recovery.AddTarget(target, neighbours, n % 2 ? weights : std::vector<Float_t>());
+    }
+    recovery.Compile(rowSignalIds);
+    return recovery;
+}
+
+void TestChannelRecovery(TRestLegacyTaskPool& pool, const std::string& what) {
+    std::mt19937 random(2);
+    std::vector<Int_t> rowSignalIds(300);
+    for (size_t r = 0; r < rowSignalIds.size(); r++) rowSignalIds[r] = r;
+    TRestLegacyChannelRecovery recovery = GenerateRecovery(random, rowSignalIds);
+    Check(recovery.GetNumberOfWaves() > 1, what + " recovery: a single wave of targets");
+
+    // Batches shorter and longer than the chunks in which each target is split
+    const std::vector<std::pair<Int_t, Int_t>> shapes = {{1, 1}, {1, 512}, {20, 512}, {64, 1024}, {3, 7000}};
+    std::vector<std::vector<Float_t>> batches, expected;
+    for (const auto& shape : shapes) {
+        std::vector<Float_t> batch(rowSignalIds.size() * shape.first * shape.second);
+        for (auto& sample : batch) sample = random() % 1000;
+        batches.push_back(batch);
+        recovery.Apply(batch.data(), shape.first, shape.second);
+        expected.push_back(batch);
+    }
+
+    for (size_t b = 0; b < shapes.size(); b++) {
+        std::vector<Float_t> batch = batches[b];
+        recovery.ApplyParallel(batch.data(), shapes[b].first, shapes[b].second, &pool);
+        Check(batch == expected[b], what + " recovery batch " + std::to_string(b) + ": samples differ");
+    }
+
+    // Batches recovered at the same time, each one parallelized on the same pool
+    std::vector<std::vector<Float_t>> nested = batches;
+    pool.ParallelFor(shapes.size(), [&](size_t b) {
+        recovery.ApplyParallel(nested[b].data(), shapes[b].first, shapes[b].second, &pool);
+    });
+    for (size_t b = 0; b < shapes.size(); b++)
+        Check(nested[b] == expected[b],
+              what + " nested recovery batch " + std::to_string(b) + ": samples differ");
+}
+}  // namespace
+
+int main() {
+    // 0 gives one thread less than the hardware cores
+    for (Int_t nThreads : {1, 3, 8, 0}) {
+        TRestLegacyTaskPool pool(nThreads);
+        std::string what = "threads=" + std::to_string(pool.GetNumberOfThreads());
+        TestSweep(pool, what);
+        TestChannelRecovery(pool, what);
+    }
+
+    std::cout << gNChecks << " checks, " << gNFailures << " failed" << std::endl;
+    return gNFailures > 0 ? 1 : 0;
+}
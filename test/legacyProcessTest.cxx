@@ -0,0 +1,96 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Test of the translation of legacy process members into their successor process.
+//
+// restLegacyProcessTest
+//
+// The successor of TRestRawZeroSuppresionProcess is created, so the library implementing it must be
+// available. Members declared by the successor class and members inherited from TRestEventProcess, such
+// as the observable settings forwarded at InitProcess, must be assigned. Unknown members and members of
+// a different type must be rejected.
+//
+// The number of failed checks is printed and returned, so that the test fails when any check fails.
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "TRestRawZeroSuppresionProcess.h"
+
+namespace {
+
+Int_t gNChecks = 0;
+Int_t gNFailures = 0;
+
+void Check(bool condition, const std::string& what) {
+    gNChecks++;
+    if (condition) return;
+    gNFailures++;
+    std::cerr << "FAILED: " << what << std::endl;
+}
+
+/// It gives access to the member translation of the legacy zero suppression process
+class TestZeroSuppressionProcess : public TRestRawZeroSuppresionProcess {
+   public:
+    using TRestLegacyProcess::SetSuccessorMember;
+};
+
+/// It returns the value of a data member of the successor, looked up independently of SetSuccessorMember
+template <typename T>
+const T& GetMember(TRestEventProcess* successor, const char* name) {
+    return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(successor) +
+                                       successor->IsA()->GetDataMemberOffset(name));
+}
+
+void TestSuccessorMembers() {
+    TestZeroSuppressionProcess process;
+    TRestEventProcess* successor = process.GetSuccessor();
+    Check(successor != nullptr, "the successor of TRestRawZeroSuppresionProcess is not available");
+    if (successor == nullptr) return;
+
+    // A member declared by the successor itself
+    Check(process.SetSuccessorMember(successor, "fZeroSuppression", true), "fZeroSuppression not assigned");
+    Check(GetMember<Bool_t>(successor, "fZeroSuppression"), "fZeroSuppression has a wrong value");
+
+    // Members inherited from TRestEventProcess
+    Check(process.SetSuccessorMember(successor, "fDynamicObs", true), "fDynamicObs not assigned");
+    Check(GetMember<bool>(successor, "fDynamicObs"), "fDynamicObs has a wrong value");
+
+    std::map<std::string, int> observables = {{"NumberOfSignals", 0}, {"BaseLineMean", 1}};
+    Check(process.SetSuccessorMember(successor, "fObservablesDefined", observables),
+          "fObservablesDefined not assigned");
+    Check((GetMember<std::map<std::string, int>>(successor, "fObservablesDefined") == observables),
+          "fObservablesDefined has a wrong value");
+
+    // Members which cannot be assigned
+    Check(!process.SetSuccessorMember(successor, "fNoSuchMember", true), "unknown member assigned");
+    Check(!process.SetSuccessorMember(successor, "fDynamicObs", 1.0), "member of a different type assigned");
+}
+}  // namespace
+
+int main() {
+    TestSuccessorMembers();
+
+    std::cout << gNChecks << " checks, " << gNFailures << " failed" << std::endl;
+    return gNFailures > 0 ? 1 : 0;
+}
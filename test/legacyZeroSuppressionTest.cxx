@@ -0,0 +1,371 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Test of the legacy zero suppression kernels against the algorithm of TRestRawZeroSuppresionProcess.
+//
+// restLegacyZeroSuppressionTest
+//
+// The original algorithm, as implemented by TRestRawSignal, is reproduced below with floating point
+// arithmetic and used as reference. Random raw signals, with random parameters, are suppressed by every
+// kernel supported by the CPU, and the surviving points must be the same as those of the reference. The
+// scalar, SSE2 and AVX2 kernels must also give bit-identical baselines. The same signals are given to
+// TRestLegacyStreamingZeroSuppression in chunks of several sizes, and the pulses it reports must contain
+// the points of the reference and their ADC values. The kernels of TRestLegacySpecializedZeroSuppression
+// are checked in the same way for each of their parameter sets. A few edge cases (baseline range past the
+// end of the signal, empty signal, no point over threshold) are checked separately. The sliding window mode
+// of the streaming zero suppression is checked to keep samples over threshold out of the baseline window,
+// and to limit the length of the pulses of a stuck channel.
+//
+// The number of failed checks is printed and returned, so that the test fails when any check fails.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TRestLegacySpecializedZeroSuppression.h"
+#include "TRestLegacyStreamingZeroSuppression.h"
+#include "TRestLegacyZeroSuppression.h"
+
+namespace {
+
+using Kernel = TRestLegacyZeroSuppression::Kernel;
+using Parameters = TRestLegacyZeroSuppression::Parameters;
+using BaseLine = TRestLegacyZeroSuppression::BaseLine;
+
+const std::vector<Kernel> kKernels = {Kernel::kScalar, Kernel::kSSE, Kernel::kAVX2};
+
+Int_t gNChecks = 0;
+Int_t gNFailures = 0;
+
+void Check(bool condition, const std::string& what) {
+    gNChecks++;
+    if (condition) return;
+    gNFailures++;
+    if (gNFailures <= 20) std::cerr << "FAILED: " << what << std::endl;
+}
+
+/// The legacy algorithm, as done by TRestRawSignal for TRestRawZeroSuppresionProcess. Ranges are
+/// clamped to the signal length, as the baseline range was in the original implementation.
+BaseLine ReferenceSuppress(const std::vector<Short_t>& signal, const Parameters& parameters,
+                           std::vector<Int_t>& points) {
+    points.clear();
+    const Int_t nBins = signal.size();
+
+    BaseLine baseLine;
+    Int_t start = std::max(parameters.fBaseLineStart, 0);
+    Int_t end = std::min(parameters.fBaseLineEnd, nBins);
+    if (end > start) {
+        for (Int_t i = start; i < end; i++) baseLine.fMean += signal[i];
+        baseLine.fMean /= end - start;
+        for (Int_t i = start; i < end; i++)
+            baseLine.fSigma += (signal[i] - baseLine.fMean) * (signal[i] - baseLine.fMean);
+        baseLine.fSigma = std::sqrt(baseLine.fSigma / (end - start));
+    }
+
+    std::vector<Double_t> data(nBins);
+    for (Int_t i = 0; i < nBins; i++) data[i] = signal[i] - baseLine.fMean;
+
+    const Double_t threshold = parameters.fPointThreshold * baseLine.fSigma;
+    start = std::max(parameters.fIntegralStart, 0);
+    end = std::min(parameters.fIntegralEnd, nBins);
+    for (Int_t i = start; i < end; i++) {
+        if (data[i] <= threshold) continue;
+
+        Int_t pos = i;
+        std::vector<Double_t> pulse = {data[i]};
+        i++;
+        Int_t flatN = 0;
+        while (i < end && data[i] > threshold) {
+            if (std::abs(data[i] - data[i - 1]) > threshold)
+                flatN = 0;
+            else
+                flatN++;
+
+            if (flatN >= parameters.fNPointsFlatThreshold) break;
+            pulse.push_back(data[i]);
+            i++;
+        }
+
+        if (pulse.size() >= (size_t)parameters.fNPointsOverThreshold) {
+            Double_t mean = std::accumulate(pulse.begin(), pulse.end(), 0.0) / pulse.size();
+            Double_t squares = std::inner_product(pulse.begin(), pulse.end(), pulse.begin(), 0.0);
+            Double_t stdev = std::sqrt(squares / pulse.size() - mean * mean);
+            if (stdev > parameters.fSignalThreshold * baseLine.fSigma)
+                for (Int_t j = pos; j < i; j++) points.push_back(j);
+        }
+    }
+    return baseLine;
+}
+
+bool SameBaseLine(const BaseLine& a, const BaseLine& b) {
+    auto close = [](Double_t x, Double_t y) { return std::abs(x - y) <= 1e-9 * std::max(1.0, std::abs(y)); };
+    return close(a.fMean, b.fMean) && close(a.fSigma, b.fSigma);
+}
+
+/// A raw signal with gaussian noise and a few pulses of random position, width and amplitude
+std::vector<Short_t> GenerateSignal(std::mt19937& random, Int_t nBins) {
+    std::normal_distribution<double> noise(250, 1 + random() % 20);
+    std::vector<Short_t> signal(nBins);
+    for (auto& adc : signal) adc = (Short_t)std::lround(noise(random));
+
+    Int_t nPulses = nBins > 0 ? random() % 6 : 0;
+    for (Int_t p = 0; p < nPulses; p++) {
+        Int_t first = random() % nBins;
+        Int_t width = 3 + random() % 80;
+        Double_t amplitude = 20 + random() % 2000;
+        for (Int_t k = 0; k < width && first + k < nBins; k++)
+            signal[first + k] += (Short_t)(amplitude * k / width * std::exp(3. - 3. * k / width) / 3.);
+    }
+    return signal;
+}
+
+Parameters GenerateParameters(std::mt19937& random, Int_t nBins) {
+    Parameters parameters;
+    parameters.fBaseLineStart = random() % 60;
+    parameters.fBaseLineEnd = parameters.fBaseLineStart + 1 + random() % 200;
+    parameters.fIntegralStart = random() % 100;
+    parameters.fIntegralEnd = random() % 2 ? nBins + 100 : parameters.fIntegralStart + random() % (nBins + 1);
+    parameters.fPointThreshold = 1 + random() % 5;
+    parameters.fSignalThreshold = random() % 5;
+    parameters.fNPointsOverThreshold = 1 + random() % 8;
+    parameters.fNPointsFlatThreshold = 1 + random() % 30;
+    return parameters;
+}
+
+/// It suppresses a signal received in chunks of several sizes, and compares the pulses with the reference
+void CheckStreaming(const std::vector<Short_t>& signal, const Parameters& parameters,
+                    const std::vector<Int_t>& expected, const std::string& what) {
+    const Int_t nBins = signal.size();
+    for (Int_t chunk : {1, 7, 64, 500, std::max(nBins, 1)}) {
+        std::vector<Int_t> points;
+        bool sameValues = true;
+        auto callback = [&](Long64_t firstBin, const Short_t* values, Int_t nValues) {
+            for (Int_t k = 0; k < nValues; k++) {
+                points.push_back(firstBin + k);
+                sameValues = sameValues && firstBin + k < nBins && values[k] == signal[firstBin + k];
+            }
+        };
+
+        TRestLegacyStreamingZeroSuppression streaming(parameters, callback);
+        for (Int_t first = 0; first < nBins; first += chunk)
+            streaming.Process(signal.data() + first, std::min(chunk, nBins - first));
+        streaming.Finish();
+
+        std::string name = what + " streaming chunk=" + std::to_string(chunk);
+        Check(points == expected, name + ": points differ from the reference");
+        Check(sameValues, name + ": pulse values differ from the signal");
+        Check(streaming.GetNumberOfSamples() == nBins, name + ": wrong number of samples");
+    }
+}
+
+/// It suppresses a signal with every supported kernel and compares the result with the reference
+void CheckKernels(const std::vector<Short_t>& signal, const Parameters& parameters, const std::string& what) {
+    std::vector<Int_t> expected;
+    BaseLine reference = ReferenceSuppress(signal, parameters, expected);
+
+    BaseLine scalar;
+    for (Kernel kernel : kKernels) {
+        if (!TRestLegacyZeroSuppression::IsKernelSupported(kernel)) continue;
+        std::vector<Int_t> points;
+        BaseLine baseLine =
+            TRestLegacyZeroSuppression::Suppress(signal.data(), signal.size(), parameters, points, kernel);
+        std::string name = what + " " + TRestLegacyZeroSuppression::GetKernelName(kernel);
+
+        Check(points == expected, name + ": points differ from the reference");
+        Check(SameBaseLine(baseLine, reference), name + ": baseline differs from the reference");
+        if (kernel == Kernel::kScalar)
+            scalar = baseLine;
+        else
+            Check(baseLine.fMean == scalar.fMean && baseLine.fSigma == scalar.fSigma,
+                  name + ": baseline is not bit-identical to the scalar kernel");
+    }
+
+    CheckStreaming(signal, parameters, expected, what);
+}
+
+void TestRandomSignals() {
+    std::mt19937 random(1);
+    for (Int_t n = 0; n < 2000; n++) {
+        Int_t nBins = 1 + random() % 2000;
+        std::vector<Short_t> signal = GenerateSignal(random, nBins);
+        // Saturated signals, to check the integer sums of the vectorized kernels
+        if (n % 100 == 0)
+            for (auto& adc : signal) adc = random() % 2 ? 32767 : -32768;
+        CheckKernels(signal, GenerateParameters(random, nBins), "signal " + std::to_string(n));
+    }
+}
+
+/// It checks the specialized kernels, with random thresholds, on random signals of their trace length
+void TestSpecializedKernels() {
+    std::mt19937 random(3);
+    for (const auto& specialization : TRestLegacySpecializedZeroSuppression::GetSpecializations()) {
+        Parameters parameters;
+        parameters.fBaseLineStart = specialization.fBaseLineStart;
+        parameters.fBaseLineEnd = specialization.fBaseLineEnd;
+        parameters.fIntegralStart = specialization.fIntegralStart;
+        parameters.fIntegralEnd = specialization.fIntegralEnd;
+        parameters.fNPointsOverThreshold = specialization.fNPointsOverThreshold;
+        const Int_t nBins = specialization.fNBins;
+
+        for (Int_t n = 0; n < 300; n++) {
+            parameters.fPointThreshold = 1 + random() % 5;
+            parameters.fSignalThreshold = random() % 5;
+            parameters.fNPointsFlatThreshold = n % 3 ? 512 : 1 + random() % 30;
+            TRestLegacySpecializedZeroSuppression zeroSuppression(parameters, nBins);
+            std::string name = "specialized nBins=" + std::to_string(nBins) + " signal " + std::to_string(n);
+            Check(zeroSuppression.IsSpecialized(), name + ": no specialized kernel selected");
+
+            std::vector<Short_t> signal = GenerateSignal(random, nBins);
+            if (n % 50 == 0)
+                for (auto& adc : signal) adc = random() % 2 ? 32767 : -32768;
+
+            std::vector<Int_t> expected, points;
+            BaseLine reference = ReferenceSuppress(signal, parameters, expected);
+            BaseLine baseLine = zeroSuppression.Suppress(signal.data(), nBins, points);
+            BaseLine scalar = TRestLegacyZeroSuppression::ComputeBaseLine(
+                signal.data(), nBins, parameters.fBaseLineStart, parameters.fBaseLineEnd, Kernel::kScalar);
+
+            Check(points == expected, name + ": points differ from the reference");
+            Check(SameBaseLine(baseLine, reference), name + ": baseline differs from the reference");
+            Check(baseLine.fMean == scalar.fMean && baseLine.fSigma == scalar.fSigma,
+                  name + ": baseline is not bit-identical to the scalar kernel");
+        }
+    }
+}
+
+void TestEdgeCases() {
+    std::mt19937 random(2);
+    Parameters parameters;
+
+    // Baseline range partially and completely past the end of the signal
+    std::vector<Short_t> signal = GenerateSignal(random, 100);
+    parameters.fBaseLineStart = 40;
+    parameters.fBaseLineEnd = 1000;
+    CheckKernels(signal, parameters, "baseline range past the end");
+    parameters.fBaseLineStart = 200;
+    CheckKernels(signal, parameters, "baseline range after the end");
+
+    // Empty signal
+    parameters = Parameters();
+    CheckStreaming({}, parameters, {}, "empty signal");
+    for (Kernel kernel : kKernels) {
+        if (!TRestLegacyZeroSuppression::IsKernelSupported(kernel)) continue;
+        std::vector<Int_t> points = {1, 2, 3};
+        BaseLine baseLine = TRestLegacyZeroSuppression::Suppress(nullptr, 0, parameters, points, kernel);
+        std::string name = "empty signal " + TRestLegacyZeroSuppression::GetKernelName(kernel);
+        Check(points.empty(), name + ": points found");
+        Check(baseLine.fMean == 0 && baseLine.fSigma == 0, name + ": baseline is not zero");
+    }
+
+    // No point over threshold, the noise never reaching five sigmas
+    signal.assign(512, 0);
+    for (size_t i = 0; i < signal.size(); i++) signal[i] = 250 + (i % 2 ? 3 : -3);
+    for (Kernel kernel : kKernels) {
+        if (!TRestLegacyZeroSuppression::IsKernelSupported(kernel)) continue;
+        std::vector<Int_t> points;
+        TRestLegacyZeroSuppression::Suppress(signal.data(), signal.size(), parameters, points, kernel);
+        Check(points.empty(), "below threshold " + TRestLegacyZeroSuppression::GetKernelName(kernel) +
+                                  ": points found");
+    }
+    CheckKernels(signal, parameters, "below threshold");
+
+    TRestLegacySpecializedZeroSuppression specialized(parameters, signal.size());
+    std::vector<Int_t> points;
+    specialized.Suppress(signal.data(), signal.size(), points);
+    Check(points.empty(), "below threshold specialized: points found");
+}
+
+/// The sliding window baseline after a pulse ending over threshold, and the pulses of a stuck channel
+void TestSlidingWindow() {
+    using BaseLineMode = TRestLegacyStreamingZeroSuppression::BaseLineMode;
+    const Int_t windowSize = 100;
+    Parameters parameters;
+    parameters.fIntegralEnd = 1 << 30;
+    parameters.fNPointsFlatThreshold = 5;
+
+    // A pulse rising to a plateau over threshold, so that it ends through the flat points rule
+    std::vector<Short_t> signal(1101);
+    for (size_t i = 0; i < signal.size(); i++) signal[i] = 250 + i % 3;
+    for (Int_t k = 0; k < 40; k++) signal[1000 + k] += k < 10 ? 60 * (k + 1) : 600;
+
+    Int_t nPulses = 0;
+    TRestLegacyStreamingZeroSuppression plateau(
+        parameters, [&](Long64_t, const Short_t*, Int_t) { nPulses++; }, BaseLineMode::kSlidingWindow,
+        windowSize);
+    plateau.Process(signal.data(), signal.size());
+    plateau.Finish();
+    Check(nPulses == 1, "sliding window plateau: wrong number of pulses");
+
+    // The window before the last sample holds the last samples under threshold, none of the plateau
+    Long64_t sum = 0, sumSquares = 0;
+    for (Int_t i = 960; i < 1100; i++) {
+        if (i >= 1000 && i < 1040) continue;
+        sum += signal[i];
+        sumSquares += (Long64_t)signal[i] * signal[i];
+    }
+    BaseLine expected = TRestLegacyZeroSuppression::GetBaseLine(sum, sumSquares, windowSize);
+    Check(SameBaseLine(plateau.GetBaseLine(), expected),
+          "sliding window plateau: samples over threshold in the baseline window");
+
+    // A stuck channel oscillating far over threshold after a few quiet samples
+    const Int_t maxPulseLength = 1000;
+    Int_t longestPulse = 0;
+    TRestLegacyStreamingZeroSuppression stuck(
+        parameters, [&](Long64_t, const Short_t*, Int_t n) { longestPulse = std::max(longestPulse, n); },
+        BaseLineMode::kSlidingWindow, windowSize);
+    Check(stuck.GetMaxPulseLength() == parameters.fIntegralEnd - parameters.fIntegralStart,
+          "sliding window stuck channel: the default maximum pulse length is not the integral range");
+    stuck.SetMaxPulseLength(maxPulseLength);
+
+    std::vector<Short_t> chunk(4096);
+    size_t maxMemory = 0;
+    for (Int_t first = 0; first < 1000000; first += chunk.size()) {
+        for (size_t i = 0; i < chunk.size(); i++)
+            chunk[i] = first + i < 500 ? 250 + i % 3 : (i % 2 ? 2000 : 1000);
+        stuck.Process(chunk.data(), chunk.size());
+        maxMemory = std::max(maxMemory, stuck.GetMemoryUsage());
+    }
+    stuck.Finish();
+    Check(longestPulse == maxPulseLength, "sliding window stuck channel: pulse longer than the maximum");
+    Check(maxMemory <= (windowSize + 2 * maxPulseLength) * sizeof(Short_t),
+          "sliding window stuck channel: memory usage not bounded by the maximum pulse length");
+}
+}  // namespace
+
+int main() {
+    for (Kernel kernel : kKernels)
+        std::cout << TRestLegacyZeroSuppression::GetKernelName(kernel) << " kernel "
+                  << (TRestLegacyZeroSuppression::IsKernelSupported(kernel) ? "tested" : "not supported")
+                  << std::endl;
+
+    TestRandomSignals();
+    TestSpecializedKernels();
+    TestEdgeCases();
+    TestSlidingWindow();
+
+    std::cout << gNChecks << " checks, " << gNFailures << " failed" << std::endl;
+    return gNFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Command line access to TRestLegacyCatalog.
+//
+// restLegacyCatalog INDEX update [-j THREADS] FILE... | @FILELIST
+// restLegacyCatalog INDEX baseline START END
+// restLegacyCatalog INDEX integral START END
+// restLegacyCatalog INDEX channel ID
+// restLegacyCatalog INDEX dump
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TRestLegacyCatalog.h"
+
+using namespace std;
+
+namespace {
+
+int Usage() {
+    cout << "Usage: restLegacyCatalog INDEX update [-j THREADS] FILE... | @FILELIST" << endl;
+    cout << "       restLegacyCatalog INDEX baseline START END" << endl;
+    cout << "       restLegacyCatalog INDEX integral START END" << endl;
+    cout << "       restLegacyCatalog INDEX channel ID" << endl;
+    cout << "       restLegacyCatalog INDEX dump" << endl;
+    return 1;
+}
+
+void Print(const vector<string>& files) {
+    for (const auto& file : files) cout << file << endl;
+}
+
+void Dump(const TRestLegacyCatalog& catalog) {
+    for (Int_t n = 0; n < catalog.GetNumberOfRecords(); n++) {
+        const auto& record = catalog.GetRecord(n);
+        cout << catalog.GetFilePath(record.fFile) << " " << catalog.GetRecordName(record);
+        if (record.fClass == TRestLegacyCatalog::kZeroSuppression) {
+            cout << " TRestRawZeroSuppresionProcess baseLineRange=(" << record.fBaseLineRange[0] << ","
+                 << record.fBaseLineRange[1] << ") integralRange=(" << record.fIntegralRange[0] << ","
+                 << record.fIntegralRange[1] << ") pointThreshold=" << record.fPointThreshold
+                 << " signalThreshold=" << record.fSignalThreshold
+                 << " pointsOverThreshold=" << record.fNPointsOverThreshold
+                 << " pointsFlatThreshold=" << record.fNPointsFlatThreshold
+                 << " sampling=" << record.fSampling;
+        } else {
+            cout << " TRestRawSignalRecoverChannelsProcess channelIds={";
+            auto channels = catalog.GetRecordChannels(record);
+            for (size_t c = 0; c < channels.size(); c++) cout << (c ? "," : "") << channels[c];
+            cout << "}";
+        }
+        cout << endl;
+    }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) return Usage();
+
+    string indexFile = argv[1];
+    string command = argv[2];
+    TRestLegacyCatalog catalog;
+
+    if (command == "update") {
+        Int_t nThreads = 0;
+        vector<string> runFiles;
+        for (int n = 3; n < argc; n++) {
+            string arg = argv[n];
+            if (arg == "-j" && n + 1 < argc) {
+                nThreads = atoi(argv[++n]);
+            } else if (arg[0] == '@') {
+                ifstream list(arg.substr(1));
+                for (string line; getline(list, line);)
+                    if (!line.empty()) runFiles.push_back(line);
+            } else {
+                runFiles.push_back(arg);
+            }
+        }
+        if (!catalog.Update(runFiles, indexFile, nThreads)) {
+            cerr << "Error writing index " << indexFile << endl;
+            return 1;
+        }
+        cout << catalog.GetNumberOfFiles() << " files, " << catalog.GetNumberOfRecords()
+             << " legacy objects indexed" << endl;
+        return 0;
+    }
+
+    if (!catalog.Open(indexFile)) {
+        cerr << "Cannot open index " << indexFile << endl;
+        return 1;
+    }
+
+    if (command == "baseline" && argc == 5)
+        Print(catalog.FindByBaseLineRange(atof(argv[3]), atof(argv[4])));
+    else if (command == "integral" && argc == 5)
+        Print(catalog.FindByIntegralRange(atof(argv[3]), atof(argv[4])));
+    else if (command == "channel" && argc == 4)
+        Print(catalog.FindByRecoveredChannel(atoi(argv[3])));
+    else if (command == "dump")
+        Dump(catalog);
+    else
+        return Usage();
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+// Command line access to TRestLegacyMigration.
+//
+// restLegacyMigrate [-j THREADS] [-m MAXMEMORY_MB] [-z zstd[:LEVEL] | -z SETTINGS] OUTDIR FILE... | @FILELIST
+
+#include <Compression.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TRestLegacyMigration.h"
+
+using namespace std;
+
+namespace {
+
+int Usage() {
+    cout << "Usage: restLegacyMigrate [-j THREADS] [-m MAXMEMORY_MB] [-z zstd[:LEVEL] | -z SETTINGS] OUTDIR "
+            "FILE... | @FILELIST"
+         << endl;
+    return 1;
+}
+
+/// It returns the compression settings given as `zstd`, `zstd:LEVEL` or a number
+Int_t GetCompression(const string& value) {
+    if (value.rfind("zstd", 0) != 0) return atoi(value.c_str());
+    Int_t level = value.size() > 5 ? atoi(value.c_str() + 5) : 5;
+    return ROOT::CompressionSettings(ROOT::RCompressionSetting::EAlgorithm::kZSTD, level);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    TRestLegacyMigration migration;
+    string outputDir;
+    vector<string> inputs;
+
+    for (int n = 1; n < argc; n++) {
+        string arg = argv[n];
+        if (arg == "-j" && n + 1 < argc) {
+            migration.SetNumberOfThreads(atoi(argv[++n]));
+        } else if (arg == "-m" && n + 1 < argc) {
+            migration.SetMaxMemory(atoll(argv[++n]) * 1000000);
+        } else if (arg == "-z" && n + 1 < argc) {
+            migration.SetCompression(GetCompression(argv[++n]));
+        } else if (outputDir.empty()) {
+            outputDir = arg;
+        } else if (arg[0] == '@') {
+            ifstream list(arg.substr(1));
+            for (string line; getline(list, line);)
+                if (!line.empty()) inputs.push_back(line);
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (outputDir.empty() || inputs.empty()) return Usage();
+
+    int nFailed = 0;
+    for (const auto& result : migration.Migrate(inputs, outputDir)) {
+        if (result.fSuccess) {
+            cout << result.fInput << " -> " << result.fOutput << " : " << result.fNTranslated
+                 << " legacy objects translated, " << result.fNTrees << " trees, " << result.fInputBytes
+                 << " -> " << result.fOutputBytes << " bytes, " << result.fTime << " s" << endl;
+        } else {
+            cerr << result.fInput << " : " << result.fMessage << endl;
+            nFailed++;
+        }
+    }
+
+    cout << inputs.size() - nFailed << " files migrated, " << nFailed << " failed" << endl;
+    return nFailed == 0 ? 0 : 1;
+}